@@ -0,0 +1,271 @@
+#ifndef ACTOR
+#define ACTOR
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Actor", which wraps an object of
+// type "T" so that it's only ever accessed by one thread at a time,
+// through messages that are simply calls to its member functions:
+//
+//     class Account
+//     {
+//     public:
+//         void Deposit(std::int64_t amount);
+//         void Transfer(Account& to, std::int64_t amount) const;
+//     };
+//
+//     ThreadPool pool; // See "ThreadPool.h"
+//     Actor<Account> account(pool); // Constructs its "Account"
+//
+//     // Any thread
+//     account.Post<&Account::Deposit>(100);
+//
+// "Post()" validates the member function against "T" at compile time via
+// "FunctionTraits" (see "FunctionTraits.h"): its class (as given by
+// "MemberFunctionClass_t") must be "T" or a base of "T", it can't be
+// rvalue reference qualified (the object persists) and the args must be
+// convertible to its arg types. The call is then queued in the actor's
+// mailbox, an "MpscCommandQueue" (see "CommandQueue.h"), as a packet
+// holding the member function's (decayed) args, whose layout is computed
+// from "ArgTypes_t" at compile time. There are therefore no hand-written
+// message types, no switch statement to dispatch them, and no allocation
+// per message ("Post()" yields if the mailbox is full, applying back
+// pressure to senders, while "TryPost()" returns false instead). Note
+// that "Post()" can therefore deadlock if nothing can drain the mailbox
+// while it waits, e.g., if an actor posts to itself (or to actors posting
+// back to it) or if every pool worker is waiting to post to a full actor,
+// so use "TryPost()" in such cases. If "Post()" throws (an arg conversion
+// throws, or the message is too large for the mailbox, see
+// "CommandQueue"), nothing is posted.
+//
+// An actor with messages in its mailbox is scheduled on the pool (once,
+// regardless of how many messages arrive, tracked by a single atomic
+// count of pending messages), where a worker drains up to
+// "ActorOptions::m_BatchSize" messages at a time (64 by default) before rescheduling the
+// actor if more remain (so a busy actor can't starve others). Messages
+// from a given thread are therefore processed in the order posted, and
+// never concurrently. Member functions must not throw
+// ("std::terminate()" is called if they do).
+//
+// The actor must not be destroyed while messages are still being posted
+// to it. The destructor waits until the messages already in the mailbox
+// have been processed.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "CommandQueue.h" and "ThreadPool.h" #include
+// "FunctionTraits.h", which #includes "CompilerVersions.h" so
+// all C++ version constants such as CPP17_OR_LATER (tested
+// just below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "CommandQueue.h"
+#include "ThreadPool.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <atomic>
+    #include <cstddef>
+    #include <thread>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    /////////////////////////////////////////////////////////////////////////
+    // ActorOptions. Optional "Actor" constructor arg
+    /////////////////////////////////////////////////////////////////////////
+    struct ActorOptions
+    {
+        std::size_t m_MailboxCapacity = 64 * 1024; // In bytes (see "CommandQueue")
+        std::size_t m_BatchSize = 64; // Max messages processed per run
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Actor. Object of type "T" accessed only via messages (calls to its member
+    // functions) processed one at a time on a "ThreadPool". See top of this
+    // file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    class Actor
+    {
+        static_assert(std::is_class_v<T> && !std::is_const_v<T> && !std::is_volatile_v<T>,
+                      "\"T\" must be a non-cv-qualified class type");
+
+    public:
+        ///////////////////////////////////////////////////////
+        // Constructs the actor's object from "args" and runs
+        // its messages on "pool"
+        ///////////////////////////////////////////////////////
+        template <typename... ArgsT,
+                  std::enable_if_t<!std::is_same_v<RemoveCvRef_t<std::tuple_element_t<0, std::tuple<ArgsT..., void>>>, ActorOptions>, int> = 0>
+        explicit Actor(ThreadPool& pool, ArgsT&&... args)
+            : Actor(pool, ActorOptions(), std::forward<ArgsT>(args)...)
+        {
+        }
+
+        ///////////////////////////////////////////////////////
+        // Same as above but with the given options
+        ///////////////////////////////////////////////////////
+        template <typename... ArgsT>
+        Actor(ThreadPool& pool, const ActorOptions& options, ArgsT&&... args)
+            : m_Pool(pool),
+              m_Mailbox(options.m_MailboxCapacity),
+              m_BatchSize(options.m_BatchSize == 0 ? 1 : options.m_BatchSize),
+              m_Object(std::forward<ArgsT>(args)...)
+        {
+        }
+
+        Actor(const Actor&) = delete;
+        Actor& operator=(const Actor&) = delete;
+
+        ~Actor()
+        {
+            while (m_PendingCount.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Posts a call to member function
+        // "MemberFunctionV" of "T" with "args" (callable from
+        // any thread), yielding while the mailbox is full.
+        // See top of this file.
+        ///////////////////////////////////////////////////////
+        template <auto MemberFunctionV, typename... ArgsT>
+        void Post(ArgsT&&... args)
+        {
+            PostImpl<true, MemberFunctionV>(std::forward<ArgsT>(args)...);
+        }
+
+        ///////////////////////////////////////////////////////
+        // Same as "Post()" above but returns false instead
+        // if the mailbox is full (so the caller can back off,
+        // or do something else, instead of waiting for the
+        // actor, which may be impossible, e.g., from one of
+        // the actor's own messages)
+        ///////////////////////////////////////////////////////
+        template <auto MemberFunctionV, typename... ArgsT>
+        bool TryPost(ArgsT&&... args)
+        {
+            return PostImpl<false, MemberFunctionV>(std::forward<ArgsT>(args)...);
+        }
+
+    private:
+        template <bool WaitV, auto MemberFunctionV, typename... ArgsT>
+        bool PostImpl(ArgsT&&... args)
+        {
+            using F = std::remove_const_t<decltype(MemberFunctionV)>;
+
+            static_assert(IsTraitsMemberFunction_v<F>, "\"MemberFunctionV\" must be a pointer to a non-static member function");
+            static_assert(std::is_base_of_v<MemberFunctionClass_t<F>, T>,
+                          "\"MemberFunctionV\" must be a member function of \"T\" (or a base class of \"T\")");
+            static_assert(FunctionReference_v<F> != FunctionReference::RValue,
+                          "\"MemberFunctionV\" can't be rvalue reference qualified");
+            static_assert(sizeof...(ArgsT) == ArgCount_v<F> && !IsVariadic_v<F>,
+                          "Number of args passed doesn't match \"MemberFunctionV\"");
+            static_assert(std::is_invocable_v<F, T&, std::decay_t<ArgsT>...>,
+                          "Args passed aren't convertible to the arg types of \"MemberFunctionV\"");
+
+            //////////////////////////////////////////////////
+            // Counted before it's queued, and the actor
+            // scheduled by whichever "Post()" makes the count
+            // nonzero (see "Run()")
+            //////////////////////////////////////////////////
+            if (m_PendingCount.fetch_add(1) == 0)
+            {
+                m_Pool.Submit(&Actor::Run, this);
+            }
+
+            bool isPosted = true;
+            try
+            {
+                MemberFunctionClass_t<F>* const object = &m_Object;
+                if constexpr (WaitV)
+                {
+                    m_Mailbox.template Push<MemberFunctionV>(object, std::forward<ArgsT>(args)...);
+                }
+                else
+                {
+                    isPosted = m_Mailbox.template TryPush<MemberFunctionV>(object, std::forward<ArgsT>(args)...);
+                }
+            }
+            catch (...)
+            {
+                m_CancelledCount.fetch_add(1);
+                throw;
+            }
+
+            if (!isPosted)
+            {
+                m_CancelledCount.fetch_add(1);
+            }
+
+            return isPosted;
+        }
+
+        static void Run(void* context) noexcept
+        {
+            Actor& actor = *static_cast<Actor*>(context);
+            ThreadPool& pool = actor.m_Pool;
+
+            /////////////////////////////////////////////////////
+            // Messages counted but not yet queued (still being
+            // pushed by "Post()") are picked up by a later run.
+            // Those that failed to be queued are uncounted here
+            // rather than by "Post()" itself since a run may
+            // already be scheduled because of them (which
+            // would then access the actor after the count
+            // dropped to zero).
+            /////////////////////////////////////////////////////
+            const std::size_t count = actor.m_Mailbox.Drain(actor.m_BatchSize) + actor.m_CancelledCount.exchange(0);
+
+            /////////////////////////////////////////////////////
+            // More messages? Reschedule (yielding to other
+            // tasks in the meantime). Otherwise the next
+            // "Post()" schedules the actor again. Note that
+            // the actor may be destroyed as soon as the count
+            // drops to zero so it's not accessed after that.
+            /////////////////////////////////////////////////////
+            if (actor.m_PendingCount.fetch_sub(count) != count)
+            {
+                pool.Submit(&Actor::Run, context);
+            }
+        }
+
+        ThreadPool& m_Pool;
+        MpscCommandQueue m_Mailbox;
+        std::size_t m_BatchSize;
+        std::atomic<std::size_t> m_PendingCount{0}; // Posted but not yet processed (the actor is scheduled while nonzero)
+        std::atomic<std::size_t> m_CancelledCount{0}; // Counted in "m_PendingCount" but not queued ("Post()" failed)
+        T m_Object;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef ACTOR (#include guard)
@@ -0,0 +1,545 @@
+#ifndef ASYNC_INVOKE
+#define ASYNC_INVOKE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "AsyncInvoke()", which runs a
+// function asynchronously on a "ThreadPool" (see "ThreadPool.h") and
+// returns an "AsyncResult", a lightweight future of its return type:
+//
+//     int Sum(const int* values, std::size_t count) noexcept;
+//
+//     ThreadPool pool;
+//     AsyncResult<int, true> result = AsyncInvoke(pool, &Sum, values, count); // "true" since "Sum()" is "noexcept"
+//     // ... later
+//     const int sum = result.Get(); // Waits if not done yet
+//
+// Unlike "std::async()" and "std::packaged_task", which allocate a shared
+// state and a type-erased callable per task, each task is a single
+// "frame" holding the shared state (reference count, ready flag, result),
+// a copy of the function (if a functor) and its args, captured in a
+// "DeferredCall" (see "DeferredCall.h") whose padding-free layout is
+// computed from "ArgTypes_t" at compile time. The frame's size is
+// therefore also known at compile time, so it's taken from a pool for the
+// smallest size class (64, 128, 256, 512 or 1024 bytes) it fits in, which
+// keeps a per-thread cache of free frames (so after warming up, tasks
+// normally don't allocate at all). Larger or over-aligned frames are
+// allocated via "operator new". The frame itself is the pool's task
+// context, so submitting it doesn't allocate either.
+//
+// The function's return type is obtained from "ReturnType_t" and, when
+// "IsNoexcept_v" is true, the task invokes it without any exception
+// handling (no try/catch, and the frame has no "std::exception_ptr" for
+// "AsyncResult::Get()" to check). Whether the function is "noexcept" is
+// therefore the second template arg of "AsyncResult". Otherwise any
+// exception it throws is rethrown by "AsyncResult::Get()".
+//
+// Note that waiting on a result from one of the pool's own worker threads
+// can deadlock if all workers do so. Destroying an "AsyncResult" without
+// waiting for it is allowed (the task still runs, and its frame is
+// released by whichever of the two finishes last).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "DeferredCall.h" and "ThreadPool.h" #include
+// "FunctionTraits.h", which #includes "CompilerVersions.h" so
+// all C++ version constants such as CPP17_OR_LATER (tested
+// just below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "DeferredCall.h"
+#include "ThreadPool.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <atomic>
+    #include <cstddef>
+    #include <exception>
+    #include <functional>
+    #include <new>
+    #include <optional>
+    #include <thread>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Size classes of the frame pools (see top of this file)
+        ////////////////////////////////////////////////////////////
+        inline constexpr std::array<std::size_t, 5> AsyncFrameSizeClasses = {64, 128, 256, 512, 1024};
+
+        // Max free frames cached per thread (per size class)
+        inline constexpr std::size_t AsyncFrameCacheSize = 256;
+
+        ////////////////////////////////////////////////////////////
+        // Index of the smallest size class "FrameT" fits in (or the
+        // number of size classes if none, or if it's over-aligned)
+        ////////////////////////////////////////////////////////////
+        template <typename FrameT>
+        constexpr std::size_t GetAsyncFrameSizeClass() noexcept
+        {
+            if (alignof(FrameT) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            {
+                return AsyncFrameSizeClasses.size();
+            }
+
+            std::size_t index = 0;
+            while (index < AsyncFrameSizeClasses.size() && AsyncFrameSizeClasses[index] < sizeof(FrameT))
+            {
+                ++index;
+            }
+
+            return index;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Per-thread cache of free frames of size class
+        // "SizeClassIndexV" (a singly linked list threaded
+        // through the free frames themselves). Frames released
+        // on a thread whose cache is full are deleted.
+        ////////////////////////////////////////////////////////////
+        template <std::size_t SizeClassIndexV>
+        class AsyncFramePool
+        {
+        public:
+            static constexpr std::size_t Size_v = AsyncFrameSizeClasses[SizeClassIndexV];
+
+            static void* Allocate()
+            {
+                Cache& cache = GetCache();
+                if (cache.m_Head)
+                {
+                    FreeFrame* const frame = cache.m_Head;
+                    cache.m_Head = frame->m_Next;
+                    --cache.m_Count;
+                    return frame;
+                }
+
+                return ::operator new(Size_v);
+            }
+
+            static void Deallocate(void* frame) noexcept
+            {
+                Cache& cache = GetCache();
+                if (cache.m_Count == AsyncFrameCacheSize)
+                {
+                    ::operator delete(frame);
+                    return;
+                }
+
+                cache.m_Head = ::new (frame) FreeFrame{cache.m_Head};
+                ++cache.m_Count;
+            }
+
+        private:
+            struct FreeFrame
+            {
+                FreeFrame* m_Next;
+            };
+
+            struct Cache
+            {
+                ~Cache()
+                {
+                    while (m_Head)
+                    {
+                        FreeFrame* const next = m_Head->m_Next;
+                        ::operator delete(m_Head);
+                        m_Head = next;
+                    }
+                }
+
+                FreeFrame* m_Head = nullptr;
+                std::size_t m_Count = 0;
+            };
+
+            static Cache& GetCache() noexcept
+            {
+                static thread_local Cache cache;
+                return cache;
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Storage for the result of a task returning "R"
+        // (references stored as pointers, nothing for "void")
+        ////////////////////////////////////////////////////////////
+        template <typename R>
+        struct AsyncValue
+        {
+            using Stored_t = std::conditional_t<std::is_reference_v<R>, std::remove_reference_t<R>*, R>;
+
+            std::optional<Stored_t> m_Value;
+
+            template <typename F>
+            void Set(F&& function)
+            {
+                if constexpr (std::is_reference_v<R>)
+                {
+                    m_Value.emplace(std::addressof(static_cast<R>(std::forward<F>(function)())));
+                }
+                else
+                {
+                    m_Value.emplace(std::forward<F>(function)());
+                }
+            }
+
+            R Get()
+            {
+                if constexpr (std::is_reference_v<R>)
+                {
+                    return static_cast<R>(**m_Value);
+                }
+                else
+                {
+                    return std::move(*m_Value);
+                }
+            }
+        };
+
+        template <>
+        struct AsyncValue<void>
+        {
+            template <typename F>
+            void Set(F&& function)
+            {
+                std::forward<F>(function)();
+            }
+
+            void Get() noexcept
+            {
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Exception thrown by a task, if any (nothing stored for
+        // "noexcept" functions, specialized below)
+        ////////////////////////////////////////////////////////////
+        template <bool IsNoexceptV>
+        struct AsyncExceptionStorage
+        {
+            void SetException(std::exception_ptr exception) noexcept
+            {
+                m_Exception = std::move(exception);
+            }
+
+            void RethrowIfException() const
+            {
+                if (m_Exception)
+                {
+                    std::rethrow_exception(m_Exception);
+                }
+            }
+
+            std::exception_ptr m_Exception;
+        };
+
+        template <>
+        struct AsyncExceptionStorage<true>
+        {
+            void RethrowIfException() const noexcept
+            {
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Shared state of a task returning "R" (the part of its
+        // frame "AsyncResult" needs)
+        ////////////////////////////////////////////////////////////
+        template <typename R, bool IsNoexceptV>
+        struct AsyncState : AsyncExceptionStorage<IsNoexceptV>
+        {
+            ////////////////////////////////////////////////////
+            // Destroys the frame and returns it to its pool
+            // (once both the task and its "AsyncResult" are
+            // done with it)
+            ////////////////////////////////////////////////////
+            void Release() noexcept
+            {
+                if (m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    m_Destroy(this);
+                }
+            }
+
+            bool IsReady() const noexcept
+            {
+                return m_Ready.load(std::memory_order_acquire);
+            }
+
+            void SetReady() noexcept
+            {
+                m_Ready.store(true, std::memory_order_release);
+
+                #if CPP20_OR_LATER
+                    m_Ready.notify_all();
+                #endif
+            }
+
+            void Wait() const noexcept
+            {
+                #if CPP20_OR_LATER
+                    m_Ready.wait(false, std::memory_order_acquire);
+                #else
+                    for (unsigned spin = 0; !IsReady(); ++spin)
+                    {
+                        if (spin >= 64)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                #endif
+            }
+
+            void (*m_Destroy)(AsyncState* state) noexcept;
+            std::atomic<unsigned> m_RefCount{2}; // The task and its "AsyncResult"
+            std::atomic<bool> m_Ready{false};
+            AsyncValue<R> m_Value;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Frame of a task invoking "FunctionT" (a function pointer
+        // or functor type), with its args captured in a
+        // "DeferredCall"
+        ////////////////////////////////////////////////////////////
+        template <typename FunctionT>
+        struct AsyncFrame : AsyncState<ReturnType_t<FunctionT>, IsNoexcept_v<FunctionT>>
+        {
+            using R = ReturnType_t<FunctionT>;
+            using Base = AsyncState<R, IsNoexcept_v<FunctionT>>;
+
+            template <typename F, typename... ArgsT>
+            AsyncFrame(F&& function, ArgsT&&... args)
+                : m_Function(std::forward<F>(function)),
+                  m_Args(std::forward<ArgsT>(args)...)
+            {
+                this->m_Destroy = &Destroy;
+            }
+
+            template <typename F, typename... ArgsT>
+            static AsyncFrame* Create(F&& function, ArgsT&&... args)
+            {
+                void* const memory = Allocate();
+                try
+                {
+                    return ::new (memory) AsyncFrame(std::forward<F>(function), std::forward<ArgsT>(args)...);
+                }
+                catch (...)
+                {
+                    Deallocate(memory);
+                    throw;
+                }
+            }
+
+            ////////////////////////////////////////////////////
+            // "ThreadPool" task (the frame is its context)
+            ////////////////////////////////////////////////////
+            static void Run(void* context) noexcept
+            {
+                AsyncFrame* const frame = static_cast<AsyncFrame*>(context);
+                const auto invoke = [frame]() -> R { return std::move(frame->m_Args).Invoke(frame->m_Function); };
+
+                if constexpr (IsNoexcept_v<FunctionT>)
+                {
+                    frame->m_Value.Set(invoke);
+                }
+                else
+                {
+                    try
+                    {
+                        frame->m_Value.Set(invoke);
+                    }
+                    catch (...)
+                    {
+                        frame->SetException(std::current_exception());
+                    }
+                }
+
+                frame->SetReady();
+                frame->Release();
+            }
+
+        private:
+            //////////////////////////////////////////////////
+            // Size class computed here, not in a static data
+            // member, since "AsyncFrame" must be complete
+            //////////////////////////////////////////////////
+            static void* Allocate()
+            {
+                constexpr std::size_t sizeClassIndex = GetAsyncFrameSizeClass<AsyncFrame>();
+                if constexpr (sizeClassIndex < AsyncFrameSizeClasses.size())
+                {
+                    return AsyncFramePool<sizeClassIndex>::Allocate();
+                }
+                else
+                {
+                    return ::operator new(sizeof(AsyncFrame), std::align_val_t(alignof(AsyncFrame)));
+                }
+            }
+
+            static void Deallocate(void* memory) noexcept
+            {
+                constexpr std::size_t sizeClassIndex = GetAsyncFrameSizeClass<AsyncFrame>();
+                if constexpr (sizeClassIndex < AsyncFrameSizeClasses.size())
+                {
+                    AsyncFramePool<sizeClassIndex>::Deallocate(memory);
+                }
+                else
+                {
+                    ::operator delete(memory, std::align_val_t(alignof(AsyncFrame)));
+                }
+            }
+
+            static void Destroy(Base* state) noexcept
+            {
+                AsyncFrame* const frame = static_cast<AsyncFrame*>(state);
+                frame->~AsyncFrame();
+                Deallocate(frame);
+            }
+
+            FunctionT m_Function;
+            DeferredCall<FunctionT> m_Args;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // AsyncResult. Lightweight (single pointer, move-only) future of the "R"
+    // returned by a function run via "AsyncInvoke()" ("IsNoexceptV" being
+    // true if the function is "noexcept")
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename R, bool IsNoexceptV = false>
+    class AsyncResult
+    {
+    public:
+        AsyncResult() noexcept = default;
+
+        explicit AsyncResult(Private::AsyncState<R, IsNoexceptV>* state) noexcept
+            : m_State(state)
+        {
+        }
+
+        AsyncResult(AsyncResult&& other) noexcept
+            : m_State(std::exchange(other.m_State, nullptr))
+        {
+        }
+
+        AsyncResult& operator=(AsyncResult&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_State = std::exchange(other.m_State, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~AsyncResult()
+        {
+            Reset();
+        }
+
+        ///////////////////////////////////////////////////
+        // Refers to a task (false if default constructed,
+        // moved from or "Get()" was called)
+        ///////////////////////////////////////////////////
+        bool IsValid() const noexcept
+        {
+            return m_State != nullptr;
+        }
+
+        bool IsReady() const noexcept
+        {
+            return m_State->IsReady();
+        }
+
+        void Wait() const noexcept
+        {
+            m_State->Wait();
+        }
+
+        ///////////////////////////////////////////////////
+        // Waits for the task, then returns its result (or
+        // rethrows its exception). Invalidates this object.
+        ///////////////////////////////////////////////////
+        R Get()
+        {
+            Wait();
+
+            ///////////////////////////////////////////////
+            // Releases the frame on exit (even if an
+            // exception is rethrown)
+            ///////////////////////////////////////////////
+            const AsyncResult release(std::exchange(m_State, nullptr));
+
+            release.m_State->RethrowIfException();
+
+            return release.m_State->m_Value.Get();
+        }
+
+    private:
+        void Reset() noexcept
+        {
+            if (m_State)
+            {
+                std::exchange(m_State, nullptr)->Release();
+            }
+        }
+
+        Private::AsyncState<R, IsNoexceptV>* m_State = nullptr;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // AsyncInvoke. Runs "function(args...)" on "pool" (a copy of "function"
+    // if a functor, and copies of "args" converted to its decayed arg
+    // types), returning its result as an "AsyncResult". "function" can be
+    // any free function (or pointer or reference to one) or functor (such
+    // as a lambda) supported by "FunctionTraits". See top of this file.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F, typename... ArgsT>
+    AsyncResult<ReturnType_t<std::decay_t<F>>, IsNoexcept_v<std::decay_t<F>>> AsyncInvoke(ThreadPool& pool, F&& function, ArgsT&&... args)
+    {
+        using FunctionT = std::decay_t<F>;
+        static_assert(IsTraitsFreeFunction_v<FunctionT> || IsTraitsFunctor_v<FunctionT>,
+                      "\"function\" must be a free function or functor (wrap member function calls in a lambda)");
+        static_assert(sizeof...(ArgsT) == ArgCount_v<FunctionT> && !IsVariadic_v<FunctionT>,
+                      "Number of args passed doesn't match \"function\"");
+
+        using FrameT = Private::AsyncFrame<FunctionT>;
+        FrameT* const frame = FrameT::Create(std::forward<F>(function), std::forward<ArgsT>(args)...);
+        AsyncResult<ReturnType_t<FunctionT>, IsNoexcept_v<FunctionT>> result(frame);
+
+        pool.Submit(&FrameT::Run, frame);
+        return result;
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef ASYNC_INVOKE (#include guard)
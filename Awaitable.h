@@ -0,0 +1,538 @@
+#ifndef AWAITABLE
+#define AWAITABLE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "AwaitInvoke()" (C++20 or later
+// only), which adapts a call to any free function, non-static member
+// function or functor supported by "FunctionTraits" (see
+// "FunctionTraits.h") into an awaitable that runs the function on a given
+// executor, e.g.:
+//
+//     std::string ReadFile(const std::filesystem::path& path); // Blocking I/O
+//
+//     ThreadPool ioPool; // See "ThreadPool.h"
+//
+//     Task<void> Load(...) // Any coroutine type
+//     {
+//         const std::string contents = co_await AwaitInvoke(ioPool, &ReadFile, path);
+//         const int count = co_await AwaitInvoke(ioPool, &Parser::Count, &parser, contents);
+//         // ...
+//     }
+//
+//     // Outside of coroutines
+//     const std::string contents = SyncWait(AwaitInvoke(ioPool, &ReadFile, path));
+//
+// The executor can be any object with a "Submit(function, context)" member
+// running "function(context)" asynchronously, such as "ThreadPool".
+//
+// "AwaitInvoke()" returns an "Awaitable<F>", a lazily started coroutine
+// that, when awaited, moves to the executor, invokes the function with
+// copies of the args (converted to its decayed arg types, as given by
+// "ArgTypes_t", plus the object for non-static member functions, stored
+// as given, so pass a pointer to avoid copying it), and resumes the
+// awaiting coroutine with the result (on the executor's thread, via
+// symmetric transfer). Its promise type stores a "ReturnType_t<F>" (or
+// nothing if "void", with references stored as pointers), and when
+// "IsNoexcept_v<F>" is true it has no exception storage at all (an
+// exception escaping the coroutine, which can then only be from the
+// executor itself, calls "std::terminate()").
+//
+// Since the coroutine's parameters are exactly the decayed arg types of
+// "F" (plus the executor and function), each signature's coroutine frame
+// always has the same size, so frames are allocated from a per-signature
+// pool that recycles freed frames (via a per-thread free list), rather
+// than from the heap on each call.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP20_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++20 or later only (coroutines). All
+// code below ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP20_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <condition_variable>
+    #include <coroutine>
+    #include <cstddef>
+    #include <exception>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <new>
+    #include <optional>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    template <TRAITS_FUNCTION_C F>
+    class Awaitable;
+
+    namespace Private
+    {
+        // Max free frames cached per thread (per signature)
+        inline constexpr std::size_t CoroutineFrameCacheSize = 64;
+
+        ////////////////////////////////////////////////////////////
+        // Recycling pool of coroutine frames for signature "F".
+        // Each free frame records its size, and is only reused for
+        // a frame of the same size (always the case in practice
+        // for a given signature, other than frames holding
+        // different executor or object types).
+        ////////////////////////////////////////////////////////////
+        template <typename F>
+        class CoroutineFramePool
+        {
+        public:
+            static void* Allocate(std::size_t size)
+            {
+                Cache& cache = GetCache();
+                if (cache.m_Head && cache.m_Head->m_Size == size)
+                {
+                    FreeFrame* const frame = cache.m_Head;
+                    cache.m_Head = frame->m_Next;
+                    --cache.m_Count;
+                    return frame;
+                }
+
+                return ::operator new(size);
+            }
+
+            static void Deallocate(void* frame, std::size_t size) noexcept
+            {
+                Cache& cache = GetCache();
+                if (cache.m_Count == CoroutineFrameCacheSize || size < sizeof(FreeFrame))
+                {
+                    ::operator delete(frame);
+                    return;
+                }
+
+                cache.m_Head = ::new (frame) FreeFrame{cache.m_Head, size};
+                ++cache.m_Count;
+            }
+
+        private:
+            struct FreeFrame
+            {
+                FreeFrame* m_Next;
+                std::size_t m_Size;
+            };
+
+            struct Cache
+            {
+                ~Cache()
+                {
+                    while (m_Head)
+                    {
+                        FreeFrame* const next = m_Head->m_Next;
+                        ::operator delete(m_Head);
+                        m_Head = next;
+                    }
+                }
+
+                FreeFrame* m_Head = nullptr;
+                std::size_t m_Count = 0;
+            };
+
+            static Cache& GetCache() noexcept
+            {
+                static thread_local Cache cache;
+                return cache;
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Exception storage of a promise (none if "IsNoexceptV")
+        ////////////////////////////////////////////////////////////
+        template <bool IsNoexceptV>
+        struct AwaitableExceptionStorage
+        {
+            void unhandled_exception() noexcept
+            {
+                m_Exception = std::current_exception();
+            }
+
+            void RethrowIfException() const
+            {
+                if (m_Exception)
+                {
+                    std::rethrow_exception(m_Exception);
+                }
+            }
+
+            std::exception_ptr m_Exception;
+        };
+
+        template <>
+        struct AwaitableExceptionStorage<true>
+        {
+            [[noreturn]] void unhandled_exception() noexcept
+            {
+                std::terminate();
+            }
+
+            void RethrowIfException() const noexcept
+            {
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Result storage of a promise returning "R" (references
+        // stored as pointers), specialized for "void" below
+        ////////////////////////////////////////////////////////////
+        template <typename R, bool IsNoexceptV>
+        struct AwaitableResult : AwaitableExceptionStorage<IsNoexceptV>
+        {
+            using Stored_t = std::conditional_t<std::is_reference_v<R>, std::remove_reference_t<R>*, R>;
+
+            template <typename T>
+            void return_value(T&& value)
+            {
+                if constexpr (std::is_reference_v<R>)
+                {
+                    m_Value.emplace(std::addressof(static_cast<R>(value)));
+                }
+                else
+                {
+                    m_Value.emplace(std::forward<T>(value));
+                }
+            }
+
+            R GetResult()
+            {
+                this->RethrowIfException();
+
+                if constexpr (std::is_reference_v<R>)
+                {
+                    return static_cast<R>(**m_Value);
+                }
+                else
+                {
+                    return std::move(*m_Value);
+                }
+            }
+
+            std::optional<Stored_t> m_Value;
+        };
+
+        template <bool IsNoexceptV>
+        struct AwaitableResult<void, IsNoexceptV> : AwaitableExceptionStorage<IsNoexceptV>
+        {
+            void return_void() noexcept
+            {
+            }
+
+            void GetResult()
+            {
+                this->RethrowIfException();
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Awaiter moving the awaiting coroutine to "ExecutorT"
+        ////////////////////////////////////////////////////////////
+        template <typename ExecutorT>
+        struct ResumeOnExecutor
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                m_Executor.Submit(&Resume, handle.address());
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+
+            static void Resume(void* context) noexcept
+            {
+                std::coroutine_handle<>::from_address(context).resume();
+            }
+
+            ExecutorT& m_Executor;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // The coroutine behind "AwaitInvoke()", whose parameters
+        // are the executor, the function, "LeadingTs" (the object
+        // for non-static member functions) and the decayed arg
+        // types of "FunctionT"
+        ////////////////////////////////////////////////////////////
+        template <typename ExecutorT, typename FunctionT, typename LeadingTupleT, typename ArgsTupleT>
+        struct AwaitInvokeImpl;
+
+        template <typename ExecutorT, typename FunctionT, typename... LeadingTs, typename... ArgsT>
+        struct AwaitInvokeImpl<ExecutorT, FunctionT, std::tuple<LeadingTs...>, std::tuple<ArgsT...>>
+        {
+            static Awaitable<FunctionT> Run(ExecutorT& executor,
+                                            FunctionT function,
+                                            LeadingTs... leadingArgs,
+                                            std::decay_t<ArgsT>... args)
+            {
+                co_await ResumeOnExecutor<ExecutorT>{executor};
+
+                if constexpr (std::is_void_v<ReturnType_t<FunctionT>>)
+                {
+                    std::invoke(function, std::move(leadingArgs)..., std::move(args)...);
+                    co_return;
+                }
+                else
+                {
+                    co_return std::invoke(function, std::move(leadingArgs)..., std::move(args)...);
+                }
+            }
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Completion signal of a coroutine run by "SyncWait()",
+        // owned by "SyncWait()" (on its stack) so signalling it
+        // never touches the coroutine's frame, which "SyncWait()"
+        // may destroy as soon as it sees "m_IsDone"
+        ////////////////////////////////////////////////////////////
+        struct AwaitableSyncWaiter
+        {
+            std::mutex m_Mutex;
+            std::condition_variable m_DoneCondition;
+            bool m_IsDone = false; // Guarded by "m_Mutex"
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Awaitable. Lazily started coroutine (move-only) invoking a function of
+    // type "F" and producing its "ReturnType_t" when awaited (once). Returned
+    // by "AwaitInvoke()". See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class Awaitable
+    {
+    public:
+        using Result_t = ReturnType_t<F>;
+
+        struct promise_type : Private::AwaitableResult<Result_t, IsNoexcept_v<F>>
+        {
+            Awaitable get_return_object() noexcept
+            {
+                return Awaitable(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            //////////////////////////////////////////////
+            // Resumes the awaiting coroutine (symmetric
+            // transfer), or signals "SyncWait()"
+            //////////////////////////////////////////////
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept
+                {
+                    promise_type& promise = handle.promise();
+                    const std::coroutine_handle<> continuation = promise.m_Continuation;
+                    Private::AwaitableSyncWaiter* const syncWaiter = promise.m_SyncWaiter;
+
+                    //////////////////////////////////////////
+                    // Set and notified under the lock, and
+                    // the promise isn't touched after that,
+                    // since "SyncWait()" may then destroy the
+                    // frame
+                    //////////////////////////////////////////
+                    if (syncWaiter)
+                    {
+                        const std::lock_guard<std::mutex> lock(syncWaiter->m_Mutex);
+                        syncWaiter->m_IsDone = true;
+                        syncWaiter->m_DoneCondition.notify_one();
+                    }
+
+                    return continuation;
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            /////////////////////////////////////////////
+            // Frames allocated from the pool for "F"
+            /////////////////////////////////////////////
+            static void* operator new(std::size_t size)
+            {
+                return Private::CoroutineFramePool<F>::Allocate(size);
+            }
+
+            static void operator delete(void* frame, std::size_t size) noexcept
+            {
+                Private::CoroutineFramePool<F>::Deallocate(frame, size);
+            }
+
+            std::coroutine_handle<> m_Continuation = std::noop_coroutine();
+            Private::AwaitableSyncWaiter* m_SyncWaiter = nullptr; // Set by "SyncWait()" only
+        };
+
+        Awaitable(Awaitable&& other) noexcept
+            : m_Handle(std::exchange(other.m_Handle, nullptr))
+        {
+        }
+
+        Awaitable& operator=(Awaitable&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Handle = std::exchange(other.m_Handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~Awaitable()
+        {
+            Reset();
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        //////////////////////////////////////////////////
+        // Starts the coroutine (symmetric transfer),
+        // which then resumes "awaiting" when done
+        //////////////////////////////////////////////////
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            m_Handle.promise().m_Continuation = awaiting;
+            return m_Handle;
+        }
+
+        Result_t await_resume()
+        {
+            return m_Handle.promise().GetResult();
+        }
+
+    private:
+        explicit Awaitable(std::coroutine_handle<promise_type> handle) noexcept
+            : m_Handle(handle)
+        {
+        }
+
+        void Reset() noexcept
+        {
+            if (m_Handle)
+            {
+                std::exchange(m_Handle, nullptr).destroy();
+            }
+        }
+
+        template <typename FunctionT>
+        friend ReturnType_t<FunctionT> SyncWait(Awaitable<FunctionT>&& awaitable);
+
+        std::coroutine_handle<promise_type> m_Handle;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // AwaitInvoke. Returns an awaitable that runs "function(args...)" on
+    // "executor" (see top of this file). For non-static member functions the
+    // first arg is the object (or a pointer to it).
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename ExecutorT, typename F, typename... ArgsT>
+    Awaitable<std::decay_t<F>> AwaitInvoke(ExecutorT& executor, F&& function, ArgsT&&... args)
+    {
+        using FunctionT = std::decay_t<F>;
+        static_assert(IsTraitsFunction_v<FunctionT> && !IsVariadic_v<FunctionT>,
+                      "\"function\" must be a non-variadic function supported by \"FunctionTraits\"");
+
+        if constexpr (std::is_member_function_pointer_v<FunctionT>)
+        {
+            static_assert(sizeof...(ArgsT) == ArgCount_v<FunctionT> + 1,
+                          "Number of args passed doesn't match \"function\" (plus the object)");
+
+            /////////////////////////////////////////////////
+            // Splits off the object (its type as passed,
+            // decayed) from the function's args
+            /////////////////////////////////////////////////
+            return [&]<typename ObjectT, typename... RestT>(ObjectT&& object, RestT&&... rest)
+            {
+                using ImplT = Private::AwaitInvokeImpl<ExecutorT, FunctionT, std::tuple<std::decay_t<ObjectT>>, ArgTypes_t<FunctionT>>;
+                return ImplT::Run(executor, std::forward<F>(function), std::forward<ObjectT>(object), std::forward<RestT>(rest)...);
+            }(std::forward<ArgsT>(args)...);
+        }
+        else
+        {
+            static_assert(sizeof...(ArgsT) == ArgCount_v<FunctionT>, "Number of args passed doesn't match \"function\"");
+
+            using ImplT = Private::AwaitInvokeImpl<ExecutorT, FunctionT, std::tuple<>, ArgTypes_t<FunctionT>>;
+            return ImplT::Run(executor, std::forward<F>(function), std::forward<ArgsT>(args)...);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // SyncWait. Runs "awaitable" (from "AwaitInvoke()") and blocks the
+    // calling thread until it's done, returning its result (or rethrowing
+    // its exception). For use outside of coroutines.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    ReturnType_t<F> SyncWait(Awaitable<F>&& awaitable)
+    {
+        const Awaitable<F> owner(std::move(awaitable));
+        auto& promise = owner.m_Handle.promise();
+
+        Private::AwaitableSyncWaiter syncWaiter;
+        promise.m_SyncWaiter = &syncWaiter;
+
+        owner.m_Handle.resume(); // Runs until it moves itself to its executor
+
+        {
+            std::unique_lock<std::mutex> lock(syncWaiter.m_Mutex);
+            syncWaiter.m_DoneCondition.wait(lock, [&syncWaiter] { return syncWaiter.m_IsDone; });
+        }
+
+        return promise.GetResult();
+    }
+} // namespace StdExt
+
+#endif // #if CPP20_OR_LATER
+
+#endif // #ifndef AWAITABLE (#include guard)
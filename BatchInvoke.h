@@ -0,0 +1,296 @@
+#ifndef BATCH_INVOKE
+#define BATCH_INVOKE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "BatchInvoke()", which applies a
+// scalar function to "count" sets of args stored as a "struct of arrays"
+// (one array per arg, plus one for the results), e.g.:
+//
+//     double Price(double spot, double strike, float vol) noexcept;
+//
+//     // Computes prices[i] = Price(spots[i], strikes[i], vols[i]) for each i
+//     BatchInvoke<&Price>(count, spots, strikes, vols, prices);
+//
+// The function's arg types and return type are obtained via
+// "FunctionTraits" (see "FunctionTraits.h") so each input array is a
+// pointer to (const) the corresponding decayed arg type and the output
+// array a pointer to the return type (in C++20 or later "std::span"
+// overloads are also available, taking the count from the output span).
+// All arg types and the return type must be trivially copyable and the
+// function can't return "void".
+//
+// The loop is laid out so the compiler can auto-vectorize it when the
+// function is inlinable (its body is visible at the call site): the
+// function is passed as a template arg (so the call is direct, unlike a
+// runtime function pointer), the arrays are declared non-aliasing
+// ("restrict"), and the loop is marked free of loop-carried dependencies
+// (via "#pragma GCC ivdep", "#pragma loop(ivdep)" or "#pragma clang loop
+// vectorize(enable)" depending on the compiler). Callers must therefore
+// ensure the output array doesn't overlap any input array. This is
+// normally far faster than the usual "array of structs" loop invoking the
+// function once per struct, whose strided loads defeat vectorization.
+// "BatchInvoke(functor, count, ...)" is also available for functors (such
+// as lambdas), which are just as inlinable.
+//
+// Where "std::experimental::simd" is available (as indicated by
+// STDEXT_BATCH_INVOKE_SIMD_SUPPORTED), "BatchInvokeSimd()" takes an
+// additional (typically generic) functor accepting and returning
+// "std::experimental::fixed_size_simd" types, which is applied to full
+// SIMD-width chunks of the arrays, and the scalar function to the
+// remaining elements. This guarantees vectorization for functions the
+// compiler can't auto-vectorize (e.g., those with branches that can be
+// expressed via "where()"). All arg and return types must be arithmetic
+// in this case.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <stdexcept>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #if CPP20_OR_LATER
+        #include <span>
+    #endif
+#endif
+
+////////////////////////////////////////////////////////////////
+// Is "std::experimental::simd" available (a non-standard
+// header so not part of "import std")
+////////////////////////////////////////////////////////////////
+#if defined(__has_include)
+    #if __has_include(<experimental/simd>)
+        #include <experimental/simd>
+        #define STDEXT_BATCH_INVOKE_SIMD_SUPPORTED 1
+    #endif
+#endif
+#if !defined(STDEXT_BATCH_INVOKE_SIMD_SUPPORTED)
+    #define STDEXT_BATCH_INVOKE_SIMD_SUPPORTED 0
+#endif
+
+////////////////////////////////////////////////////////////////
+// Non-standard "restrict" qualifier and "no loop-carried
+// dependencies" loop hint for each compiler (both #undefined
+// at the end of this file)
+////////////////////////////////////////////////////////////////
+#if defined(MICROSOFT_COMPILER)
+    #define BATCH_INVOKE_RESTRICT __restrict
+    #define BATCH_INVOKE_IVDEP __pragma(loop(ivdep))
+#elif defined(GCC_COMPILER)
+    #define BATCH_INVOKE_RESTRICT __restrict__
+    #define BATCH_INVOKE_IVDEP _Pragma("GCC ivdep")
+#else // Clang or Intel
+    #define BATCH_INVOKE_RESTRICT __restrict__
+    #define BATCH_INVOKE_IVDEP _Pragma("clang loop vectorize(enable)")
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        template <typename ReturnT, typename TupleT>
+        struct BatchInvokeImpl;
+
+        template <typename ReturnT, typename... ArgsT>
+        struct BatchInvokeImpl<ReturnT, std::tuple<ArgsT...>>
+        {
+            static_assert(!std::is_void_v<ReturnT>, "Functions passed to \"BatchInvoke()\" can't return void");
+            static_assert(std::is_trivially_copyable_v<ReturnT> && (std::is_trivially_copyable_v<std::decay_t<ArgsT>> && ...),
+                          "Functions passed to \"BatchInvoke()\" must have trivially copyable (decayed) arg and return types");
+
+            using Output_t = std::remove_cv_t<std::remove_reference_t<ReturnT>>;
+
+            template <typename F>
+            static void Invoke(F&& function,
+                               std::size_t count,
+                               const std::decay_t<ArgsT>* BATCH_INVOKE_RESTRICT... inputs,
+                               Output_t* BATCH_INVOKE_RESTRICT output)
+            {
+                BATCH_INVOKE_IVDEP
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    output[i] = function(inputs[i]...);
+                }
+            }
+
+            #if CPP20_OR_LATER
+                template <typename F>
+                static void Invoke(F&& function,
+                                   std::span<const std::decay_t<ArgsT>>... inputs,
+                                   std::span<Output_t> output)
+                {
+                    /////////////////////////////////////////////////
+                    // Inputs shorter than the output would be read
+                    // past their end
+                    /////////////////////////////////////////////////
+                    if (((inputs.size() < output.size()) || ...))
+                    {
+                        throw std::out_of_range("\"BatchInvoke()\" input span smaller than its output span");
+                    }
+
+                    Invoke(std::forward<F>(function), output.size(), inputs.data()..., output.data());
+                }
+            #endif
+
+            #if STDEXT_BATCH_INVOKE_SIMD_SUPPORTED
+                ///////////////////////////////////////////////////
+                // SIMD width used for all args and the return
+                // type (the native width of the return type)
+                ///////////////////////////////////////////////////
+                static constexpr std::size_t SimdWidth_v = std::experimental::native_simd<Output_t>::size();
+
+                template <typename SimdF, typename ScalarF>
+                static void InvokeSimd(SimdF&& simdFunction,
+                                       ScalarF&& scalarFunction,
+                                       std::size_t count,
+                                       const std::decay_t<ArgsT>* BATCH_INVOKE_RESTRICT... inputs,
+                                       Output_t* BATCH_INVOKE_RESTRICT output)
+                {
+                    static_assert(std::is_arithmetic_v<Output_t> && (std::is_arithmetic_v<std::decay_t<ArgsT>> && ...),
+                                  "Functions passed to \"BatchInvokeSimd()\" must have arithmetic arg and return types");
+
+                    namespace stdx = std::experimental;
+
+                    const std::size_t simdCount = count - count % SimdWidth_v;
+                    for (std::size_t i = 0; i < simdCount; i += SimdWidth_v)
+                    {
+                        const stdx::fixed_size_simd<Output_t, SimdWidth_v> result =
+                            simdFunction(stdx::fixed_size_simd<std::decay_t<ArgsT>, SimdWidth_v>(inputs + i, stdx::element_aligned)...);
+                        result.copy_to(output + i, stdx::element_aligned);
+                    }
+
+                    // Remainder (fewer than "SimdWidth_v" elements)
+                    Invoke(std::forward<ScalarF>(scalarFunction), count - simdCount, (inputs + simdCount)..., output + simdCount);
+                }
+            #endif
+        };
+
+        template <typename F>
+        using BatchInvokeImpl_t = BatchInvokeImpl<ReturnType_t<F>, ArgTypes_t<F>>;
+
+        template <typename F>
+        inline constexpr bool IsBatchInvokable_v = !std::is_member_function_pointer_v<F> && !IsVariadic_v<F>;
+
+        ////////////////////////////////////////////////////////////
+        // Calls "FunctionV" directly (so it's inlinable) when
+        // passed as a functor
+        ////////////////////////////////////////////////////////////
+        template <auto FunctionV>
+        struct BatchInvokeStatic
+        {
+            template <typename... ArgsT>
+            decltype(auto) operator()(ArgsT&&... args) const
+            {
+                return FunctionV(std::forward<ArgsT>(args)...);
+            }
+        };
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // BatchInvoke. Computes output[i] = FunctionV(inputs[i]...) for each
+    // "i" in [0, count), where "FunctionV" is a pointer to a free function
+    // (or static member function) and "inputs" are pointers to (const) its
+    // decayed arg types (in order). See top of this file for details.
+    ///////////////////////////////////////////////////////////////////////////
+    template <auto FunctionV, typename... ArgsT>
+    void BatchInvoke(std::size_t count, ArgsT&&... args)
+    {
+        using F = std::remove_const_t<decltype(FunctionV)>;
+        static_assert(IsTraitsFreeFunction_v<F> && Private::IsBatchInvokable_v<F>,
+                      "\"FunctionV\" must be a pointer to a non-variadic free function");
+
+        Private::BatchInvokeImpl_t<F>::Invoke(Private::BatchInvokeStatic<FunctionV>(), count, std::forward<ArgsT>(args)...);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // BatchInvoke. Same as above but for a functor (such as a lambda) or a
+    // free function passed at runtime (not inlinable unless the compiler can
+    // propagate the pointer's value)
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F, typename... ArgsT>
+    void BatchInvoke(F&& function, std::size_t count, ArgsT&&... args)
+    {
+        using FunctionT = RemoveCvRef_t<F>;
+        static_assert(IsTraitsFunction_v<FunctionT> && Private::IsBatchInvokable_v<FunctionT>,
+                      "\"function\" must be a non-variadic free function or functor");
+
+        Private::BatchInvokeImpl_t<FunctionT>::Invoke(std::forward<F>(function), count, std::forward<ArgsT>(args)...);
+    }
+
+    #if CPP20_OR_LATER
+        ///////////////////////////////////////////////////////////////////////
+        // BatchInvoke. Span overloads of the above, computing output[i] for
+        // each element of the output span (the last arg). Throws
+        // "std::out_of_range" if any input span is smaller.
+        ///////////////////////////////////////////////////////////////////////
+        template <auto FunctionV, typename... SpansT>
+        void BatchInvoke(std::span<SpansT>... spans)
+        {
+            using F = std::remove_const_t<decltype(FunctionV)>;
+            static_assert(IsTraitsFreeFunction_v<F> && Private::IsBatchInvokable_v<F>,
+                          "\"FunctionV\" must be a pointer to a non-variadic free function");
+
+            Private::BatchInvokeImpl_t<F>::Invoke(Private::BatchInvokeStatic<FunctionV>(), spans...);
+        }
+    #endif
+
+    #if STDEXT_BATCH_INVOKE_SIMD_SUPPORTED
+        ///////////////////////////////////////////////////////////////////////
+        // BatchInvokeSimd. Same as "BatchInvoke<FunctionV>()" but applies
+        // "simdFunction" to full SIMD-width chunks (see top of this file).
+        // "simdFunction" is invoked with a "fixed_size_simd" for each arg
+        // (all of the same width) and must return a "fixed_size_simd" of the
+        // return type of "FunctionV" (of the same width).
+        ///////////////////////////////////////////////////////////////////////
+        template <auto FunctionV, typename SimdF, typename... ArgsT>
+        void BatchInvokeSimd(SimdF&& simdFunction, std::size_t count, ArgsT&&... args)
+        {
+            using F = std::remove_const_t<decltype(FunctionV)>;
+            static_assert(IsTraitsFreeFunction_v<F> && Private::IsBatchInvokable_v<F>,
+                          "\"FunctionV\" must be a pointer to a non-variadic free function");
+
+            Private::BatchInvokeImpl_t<F>::InvokeSimd(std::forward<SimdF>(simdFunction),
+                                                      Private::BatchInvokeStatic<FunctionV>(),
+                                                      count,
+                                                      std::forward<ArgsT>(args)...);
+        }
+    #endif
+} // namespace StdExt
+
+#undef BATCH_INVOKE_RESTRICT
+#undef BATCH_INVOKE_IVDEP
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef BATCH_INVOKE (#include guard)
@@ -0,0 +1,379 @@
+#ifndef BIND_ARGS
+#define BIND_ARGS
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "BindArgs()", an alternative to
+// "std::bind()" for partial application, binding values to the args of a
+// function at given (zero-based) indexes, e.g.:
+//
+//     void Log(Severity severity, std::string_view channel, std::string_view message) noexcept;
+//
+//     // "void (std::string_view message) noexcept"
+//     const auto logNetWarning = BindArgs<0, 1>(&Log, Severity::Warning, std::string_view("net"));
+//
+//     logNetWarning("Connection reset");
+//
+// Unlike "std::bind()", there are no placeholders: the indexes of the
+// bound args are template args (which must be strictly increasing, each
+// less than the function's arg count) and the remaining args are simply
+// those not bound, in their original order. The resulting functor, a
+// "BoundArgs", therefore has a single (non-template) "operator()" whose
+// signature is that of the function with the bound args removed (i.e.,
+// "FunctionTraits::ArgsDelete_t" applied for each bound index, see
+// "FunctionTraits.h"), taking the remaining args by their exact types. It
+// returns the function's return type and is "noexcept" if the function
+// is and passing each bound value (and each remaining arg) to the
+// function can't throw. It's available as "BoundArgs::Signature_t", and
+// "BoundArgs" itself is a functor supported by "FunctionTraits".
+//
+// The function can be a functor (including a non-generic lambda) or a
+// pointer to a free function, and is stored (by value) along with the
+// bound values (decayed copies) in the "BoundArgs" itself, ordered by
+// alignment so no padding is needed between them (so the size of a
+// "BoundArgs" is known at compile time, with no type erasure or heap
+// allocation, and the function is called directly). Bound values are
+// passed to the function as "const" lvalues so use "std::ref()" to bind
+// an arg taken by non-const reference.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only, and requires
+// function write traits ("ArgsDelete_t"), which aren't
+// available if FUNCTION_WRITE_TRAITS_SUPPORTED isn't #defined
+// (VC++ from Visual Studio 2017, or if the user #defines
+// REMOVE_FUNCTION_WRITE_TRAITS). All code below ignored
+// otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER && defined(FUNCTION_WRITE_TRAITS_SUPPORTED)
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        template <std::size_t... Is>
+        constexpr bool IsStrictlyIncreasing() noexcept
+        {
+            constexpr std::array<std::size_t, sizeof...(Is)> indexes = {Is...};
+
+            for (std::size_t i = 1; i < indexes.size(); ++i)
+            {
+                if (indexes[i - 1] >= indexes[i])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // "F" with the args at indexes "Is" (strictly increasing)
+        // removed, via "ArgsDelete_t" (last index first so the
+        // remaining indexes are unaffected)
+        ////////////////////////////////////////////////////////////
+        template <typename F,
+                  std::size_t... Is>
+        struct BindArgsDelete
+        {
+            using Type = F;
+        };
+
+        template <typename F,
+                  std::size_t I,
+                  std::size_t... Is>
+        struct BindArgsDelete<F, I, Is...>
+        {
+            using Type = ArgsDelete_t<typename BindArgsDelete<F, Is...>::Type, I, 1>;
+        };
+
+        template <typename F,
+                  std::size_t... Is>
+        using BindArgsDelete_t = typename BindArgsDelete<F, Is...>::Type;
+
+        template <typename F,
+                  typename BoundTupleT,
+                  std::size_t... Is>
+        struct IsBindArgsConstructible;
+
+        template <typename F,
+                  typename... BoundT,
+                  std::size_t... Is>
+        struct IsBindArgsConstructible<F, std::tuple<BoundT...>, Is...>
+            : std::bool_constant<(std::is_constructible_v<ArgType_t<F, Is>, const BoundT&> && ...)>
+        {
+        };
+
+        template <typename F,
+                  typename BoundTupleT,
+                  std::size_t... Is>
+        constexpr bool IsValidBindArgs() noexcept
+        {
+            static_assert(IsTraitsFreeFunction_v<std::remove_pointer_t<F>> || IsTraitsFunctor_v<F>,
+                          "The function passed to \"BindArgs()\" must be a functor (non-generic lambdas included) "
+                          "or a pointer to a free function");
+            static_assert(!IsVariadic_v<F>, "The function passed to \"BindArgs()\" can't be variadic");
+            static_assert(std::tuple_size_v<BoundTupleT> == sizeof...(Is),
+                          "\"BindArgs()\" must be passed one value for each (template arg) index");
+            static_assert(IsStrictlyIncreasing<Is...>(),
+                          "The indexes passed to \"BindArgs()\" must be strictly increasing");
+            static_assert(((Is < ArgCount_v<F>) && ...),
+                          "An index passed to \"BindArgs()\" is out of range (not less than the function's arg count)");
+
+            if constexpr (((Is < ArgCount_v<F>) && ...) && std::tuple_size_v<BoundTupleT> == sizeof...(Is))
+            {
+                static_assert(IsBindArgsConstructible<F, BoundTupleT, Is...>::value,
+                              "A value passed to \"BindArgs()\" can't be passed to the function's arg at its index "
+                              "(as a \"const\" lvalue)");
+            }
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Order in which to store "Ts" (their indexes in "Ts"),
+        // sorted by decreasing alignment (stable)
+        ////////////////////////////////////////////////////////////
+        template <typename... Ts>
+        constexpr std::array<std::size_t, sizeof...(Ts)> GetBindArgsStorageOrder() noexcept
+        {
+            constexpr std::array<std::size_t, sizeof...(Ts)> alignments = {alignof(Ts)...};
+
+            std::array<std::size_t, sizeof...(Ts)> order{};
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                std::size_t j = i;
+                for (; j != 0 && alignments[order[j - 1]] < alignments[i]; --j)
+                {
+                    order[j] = order[j - 1];
+                }
+                order[j] = i;
+            }
+
+            return order;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Position in "order" (see "GetBindArgsStorageOrder()") of
+        // index "I"
+        ////////////////////////////////////////////////////////////
+        template <std::size_t I,
+                  std::size_t N>
+        constexpr std::size_t GetBindArgsStoragePosition(const std::array<std::size_t, N>& order) noexcept
+        {
+            std::size_t position = 0;
+            while (order[position] != I)
+            {
+                ++position;
+            }
+
+            return position;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Position in "Is" (bound indexes) of arg index "J", or
+        // "sizeof...(Is)" if "J" isn't bound
+        ////////////////////////////////////////////////////////////
+        template <std::size_t J,
+                  std::size_t... Is>
+        constexpr std::size_t GetBoundArgPosition() noexcept
+        {
+            constexpr std::array<std::size_t, sizeof...(Is)> indexes = {Is...};
+
+            std::size_t position = 0;
+            while (position < indexes.size() && indexes[position] != J)
+            {
+                ++position;
+            }
+
+            return position;
+        }
+
+        // Index of arg "J" among the args not bound (if it isn't)
+        template <std::size_t J,
+                  std::size_t... Is>
+        inline constexpr std::size_t UnboundArgIndex_v = J - (std::size_t{Is < J} + ... + 0);
+
+        ////////////////////////////////////////////////////////////
+        // "BoundArgs" (declared after this namespace), specialized
+        // on the remaining (unbound) arg types so "operator()"
+        // takes them by their exact (declared) types. Function "F"
+        // and "BoundT" are stored in "m_Storage" in the order given
+        // by "GetBindArgsStorageOrder()".
+        ////////////////////////////////////////////////////////////
+        template <typename F,
+                  typename BoundIndexesT,
+                  typename ArgTypesTupleT,
+                  typename... BoundT>
+        class BoundArgsBase;
+
+        template <typename F,
+                  std::size_t... Is,
+                  typename... ArgsT,
+                  typename... BoundT>
+        class BoundArgsBase<F, std::index_sequence<Is...>, std::tuple<ArgsT...>, BoundT...>
+        {
+            using StoredTupleT = std::tuple<F, BoundT...>;
+            static constexpr std::array<std::size_t, sizeof...(BoundT) + 1> StorageOrder_v = GetBindArgsStorageOrder<F, BoundT...>();
+
+            template <typename IndexSequenceT>
+            struct Storage;
+
+            template <std::size_t... Ks>
+            struct Storage<std::index_sequence<Ks...>>
+            {
+                using Type = std::tuple<std::tuple_element_t<StorageOrder_v[Ks], StoredTupleT>...>;
+            };
+
+            using StorageT = typename Storage<std::make_index_sequence<sizeof...(BoundT) + 1>>::Type;
+
+        public:
+            using Return_t = ReturnType_t<F>;
+            static constexpr bool IsNoexcept_v = StdExt::IsNoexcept_v<F> &&
+                                                 (std::is_nothrow_constructible_v<ArgType_t<F, Is>, const BoundT&> && ...) &&
+                                                 (std::is_nothrow_constructible_v<ArgsT, ArgsT&&> && ...);
+            using Signature_t = Return_t (ArgsT...) noexcept(IsNoexcept_v);
+
+            template <typename FunctionT,
+                      typename... BoundToStoreT>
+            explicit constexpr BoundArgsBase(std::in_place_t, FunctionT&& function, BoundToStoreT&&... values)
+                : BoundArgsBase(std::forward_as_tuple(std::forward<FunctionT>(function), std::forward<BoundToStoreT>(values)...),
+                                std::make_index_sequence<sizeof...(BoundT) + 1>())
+            {
+            }
+
+            constexpr Return_t operator()(ArgsT... args) const noexcept(IsNoexcept_v)
+            {
+                return Invoke(std::forward_as_tuple(std::forward<ArgsT>(args)...),
+                              std::make_index_sequence<sizeof...(ArgsT) + sizeof...(BoundT)>());
+            }
+
+        private:
+            ///////////////////////////////////////////////////
+            // Stores the function and bound values (all in
+            // "toStore", in their original order) in the
+            // storage order
+            ///////////////////////////////////////////////////
+            template <typename ToStoreTupleT,
+                      std::size_t... Ks>
+            constexpr BoundArgsBase(ToStoreTupleT&& toStore, std::index_sequence<Ks...>)
+                : m_Storage(std::get<StorageOrder_v[Ks]>(std::move(toStore))...)
+            {
+            }
+
+            template <typename ArgsTupleT,
+                      std::size_t... Js>
+            constexpr Return_t Invoke(ArgsTupleT&& args, std::index_sequence<Js...>) const noexcept(IsNoexcept_v)
+            {
+                return std::get<GetBindArgsStoragePosition<0>(StorageOrder_v)>(m_Storage)(GetArg<Js>(args)...);
+            }
+
+            ///////////////////////////////////////////////////
+            // Arg "J" of the function, either a bound value
+            // or one of "args" (passed to "operator()")
+            ///////////////////////////////////////////////////
+            template <std::size_t J,
+                      typename ArgsTupleT>
+            constexpr decltype(auto) GetArg(ArgsTupleT& args) const noexcept
+            {
+                constexpr std::size_t boundPosition = GetBoundArgPosition<J, Is...>();
+
+                if constexpr (boundPosition != sizeof...(Is))
+                {
+                    return std::get<GetBindArgsStoragePosition<boundPosition + 1>(StorageOrder_v)>(m_Storage);
+                }
+                else
+                {
+                    return std::get<UnboundArgIndex_v<J, Is...>>(std::move(args));
+                }
+            }
+
+            StorageT m_Storage;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // BoundArgs. Functor calling "F" with values "BoundT" bound to its args at
+    // indexes "Is" (strictly increasing) and its remaining args passed to
+    // "operator()". Normally created via "BindArgs()" below. See top of this
+    // file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename BoundIndexesT,
+              typename... BoundT>
+    class BoundArgs;
+
+    template <typename F,
+              std::size_t... Is,
+              typename... BoundT>
+    class BoundArgs<F, std::index_sequence<Is...>, BoundT...>
+        : public Private::BoundArgsBase<F,
+                                        std::index_sequence<Is...>,
+                                        ArgTypes_t<Private::BindArgsDelete_t<F, Is...>>,
+                                        BoundT...>
+    {
+        using BaseClass = Private::BoundArgsBase<F,
+                                                 std::index_sequence<Is...>,
+                                                 ArgTypes_t<Private::BindArgsDelete_t<F, Is...>>,
+                                                 BoundT...>;
+
+    public:
+        using BaseClass::BaseClass;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // BindArgs(). Returns a "BoundArgs" functor calling "function" with
+    // "values" bound to its args at (zero-based) indexes "Is" (strictly
+    // increasing, one per value) and its remaining args passed to the
+    // functor's "operator()" (in their original order). See top of this file
+    // for details.
+    ///////////////////////////////////////////////////////////////////////////
+    template <std::size_t... Is,
+              typename FunctionT,
+              typename... ValuesT>
+    constexpr auto BindArgs(FunctionT&& function, ValuesT&&... values)
+    {
+        using F = std::decay_t<FunctionT>;
+        static_assert(Private::IsValidBindArgs<F, std::tuple<std::decay_t<ValuesT>...>, Is...>());
+
+        return BoundArgs<F, std::index_sequence<Is...>, std::decay_t<ValuesT>...>(std::in_place,
+                                                                                std::forward<FunctionT>(function),
+                                                                                std::forward<ValuesT>(values)...);
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER && defined(FUNCTION_WRITE_TRAITS_SUPPORTED)
+
+#endif // #ifndef BIND_ARGS (#include guard)
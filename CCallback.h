@@ -0,0 +1,474 @@
+#ifndef C_CALLBACK
+#define C_CALLBACK
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "MakeCCallback()", which turns
+// any callable (normally a capturing lambda) into a C callback, i.e., a
+// plain function pointer plus a "void*" user data arg, as taken by most C
+// libraries, e.g.:
+//
+//     // C API: void lib_read(lib_stream*, void (*callback)(void* userData, int status, size_t size), void* userData);
+//
+//     // "void (*)(void*, int, size_t)" (user data inserted at index 0 by default)
+//     const auto callback = MakeCCallback<void (int status, size_t size)>([&](int status, size_t size)
+//                                                                         {
+//                                                                             connection.OnRead(status, size);
+//                                                                         });
+//
+//     lib_read(stream, callback.GetFunction(), callback.GetUserData());
+//
+// Template arg "CSignatureT" is the callback's signature without its user
+// data arg (a free function type or pointer), which is inserted at index
+// "UserDataIndexV" (0 by default, or "ArgCount_v<CSignatureT>" to append
+// it) via "ArgsInsert_t" (or "ArgsAppend_t", see "FunctionTraits.h"),
+// giving "CCallback::Function_t". The function returned by "GetFunction()"
+// is a captureless trampoline generated for the callable's type, which
+// casts the user data back to the callable and calls it with the
+// remaining args, so it can be inlined into the trampoline (there's no
+// type erasure or "std::function" involved). The callable must be
+// callable with those args (and return something convertible to the
+// callback's return type), and must not throw ("std::terminate()" is
+// called if it does, since exceptions can't propagate through C code).
+// The callback must have the default calling convention (normally
+// "cdecl"), since the trampoline is declared with it (so callbacks using
+// "__stdcall" for instance are rejected at compile time in 32 bit builds
+// where it differs).
+//
+// The callable (decayed copy) is stored in a block allocated from a
+// "CCallbackPool" (the default pool unless one is passed), which
+// allocates blocks of a few size classes (up to 256 bytes, checked at
+// compile time, so capture large state by pointer instead) from slabs of
+// 256 blocks each and recycles them through free lists, so creating a
+// callback doesn't allocate once the pool has grown to its working set.
+// Pools are thread-safe (callbacks can be created and destroyed on any
+// thread) and must outlive their callbacks (the default pool outlives all
+// callbacks created with it). The returned "CCallback" owns the block and
+// destroys the callable (returning the block to its pool) when destroyed
+// or reset, so it must outlive the callback's registration with the C
+// library.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only, and requires
+// function write traits ("ArgsInsert_t" and "ArgsAppend_t"), which aren't
+// available if FUNCTION_WRITE_TRAITS_SUPPORTED isn't #defined
+// (VC++ from Visual Studio 2017, or if the user #defines
+// REMOVE_FUNCTION_WRITE_TRAITS). All code below ignored
+// otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER && defined(FUNCTION_WRITE_TRAITS_SUPPORTED)
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <memory>
+    #include <mutex>
+    #include <new>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        // Block sizes of each size class
+        inline constexpr std::array<std::size_t, 5> CCallbackBlockSizeClasses = {16, 32, 64, 128, 256};
+
+        // Blocks allocated at once (per slab) when a size class has no free block
+        inline constexpr std::size_t CCallbackBlocksPerSlab = 256;
+
+        ////////////////////////////////////////////////////////////
+        // Free block (holding the callable otherwise), linked into
+        // its size class's free list
+        ////////////////////////////////////////////////////////////
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) CCallbackBlock
+        {
+            CCallbackBlock* m_Next;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Index of the smallest size class "CallableT" fits in (or
+        // the number of size classes if none, or if it's
+        // over-aligned)
+        ////////////////////////////////////////////////////////////
+        template <typename CallableT>
+        constexpr std::size_t GetCCallbackSizeClass() noexcept
+        {
+            if (alignof(CallableT) > alignof(CCallbackBlock))
+            {
+                return CCallbackBlockSizeClasses.size();
+            }
+
+            std::size_t index = 0;
+            while (index < CCallbackBlockSizeClasses.size() && CCallbackBlockSizeClasses[index] < sizeof(CallableT))
+            {
+                ++index;
+            }
+
+            return index;
+        }
+
+        template <typename CSignatureT>
+        constexpr bool IsValidCSignature() noexcept
+        {
+            static_assert(IsTraitsFreeFunction_v<std::remove_pointer_t<CSignatureT>>,
+                          "\"CSignatureT\" must be a free function type (or pointer to one)");
+            static_assert(!IsVariadic_v<CSignatureT>, "\"CSignatureT\" can't be variadic");
+
+            ///////////////////////////////////////////////////
+            // The trampoline is declared with the default
+            // calling convention (normally "cdecl"), so the
+            // callback must use it too. Note that other
+            // calling conventions are normally ignored (the
+            // default used instead) in 64 bit builds so this
+            // only affects 32 bit builds in practice.
+            ///////////////////////////////////////////////////
+            static_assert(CallingConvention_v<CSignatureT> == CallingConvention_v<void ()>,
+                          "\"CSignatureT\" must have the default calling convention (normally \"cdecl\"), "
+                          "the one \"MakeCCallback()\" trampolines are declared with");
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Function type "CSignatureT" (a free function type) with
+        // a "void*" (user data) arg inserted at "UserDataIndexV"
+        ////////////////////////////////////////////////////////////
+        template <typename CSignatureT,
+                  std::size_t UserDataIndexV,
+                  bool IsAppendV = (UserDataIndexV == ArgCount_v<CSignatureT>)>
+        struct CCallbackFunction
+        {
+            using Type = ArgsInsert_t<CSignatureT, UserDataIndexV, void*>;
+        };
+
+        template <typename CSignatureT,
+                  std::size_t UserDataIndexV>
+        struct CCallbackFunction<CSignatureT, UserDataIndexV, true>
+        {
+            using Type = ArgsAppend_t<CSignatureT, void*>;
+        };
+
+        template <typename CallableT,
+                  typename ReturnT,
+                  typename ArgTypesTupleT>
+        struct IsCCallbackCallable;
+
+        template <typename CallableT,
+                  typename ReturnT,
+                  typename... ArgsT>
+        struct IsCCallbackCallable<CallableT, ReturnT, std::tuple<ArgsT...>> : std::is_invocable_r<ReturnT, CallableT&, ArgsT...>
+        {
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Trampolines for C callbacks with return type "ReturnT"
+        // and arg types "ParamsT" (including the user data at
+        // "UserDataIndexV"), one per callable type
+        ////////////////////////////////////////////////////////////
+        template <typename ReturnT,
+                  typename ParamsTupleT,
+                  std::size_t UserDataIndexV>
+        struct CCallbackTrampoline;
+
+        template <typename ReturnT,
+                  typename... ParamsT,
+                  std::size_t UserDataIndexV>
+        struct CCallbackTrampoline<ReturnT, std::tuple<ParamsT...>, UserDataIndexV>
+        {
+            template <typename CallableT>
+            static ReturnT Invoke(ParamsT... params) noexcept
+            {
+                return InvokeCallable<CallableT>(std::tuple<ParamsT&...>(params...),
+                                                 std::make_index_sequence<sizeof...(ParamsT) - 1>());
+            }
+
+            ///////////////////////////////////////////////////
+            // Calls the callable (pointed to by the user data)
+            // with all other args, arg "Js" of the callable
+            // being arg "Js" of "params" if before the user
+            // data or the following arg otherwise
+            ///////////////////////////////////////////////////
+            template <typename CallableT,
+                      std::size_t... Js>
+            static ReturnT InvokeCallable(std::tuple<ParamsT&...> params, std::index_sequence<Js...>) noexcept
+            {
+                CallableT& callable = *static_cast<CallableT*>(std::get<UserDataIndexV>(params));
+
+                if constexpr (std::is_void_v<ReturnT>)
+                {
+                    callable(std::get<Js + (Js >= UserDataIndexV)>(params)...);
+                }
+                else
+                {
+                    return callable(std::get<Js + (Js >= UserDataIndexV)>(params)...);
+                }
+            }
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // CCallbackPool. Pool the callables of "CCallback"s are stored in. See
+    // top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    class CCallbackPool
+    {
+    public:
+        CCallbackPool() = default;
+        CCallbackPool(const CCallbackPool&) = delete;
+        CCallbackPool& operator=(const CCallbackPool&) = delete;
+
+        ///////////////////////////////////////////////////////
+        // Pool used by "MakeCCallback()" when no pool is
+        // passed
+        ///////////////////////////////////////////////////////
+        static CCallbackPool& GetDefault()
+        {
+            static CCallbackPool pool;
+            return pool;
+        }
+
+        // Number of blocks currently allocated (i.e., live callbacks)
+        std::size_t GetAllocatedCount() const
+        {
+            const std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_AllocatedCount;
+        }
+
+    private:
+        template <typename CSignatureT, std::size_t UserDataIndexV>
+        friend class CCallback;
+
+        void* Allocate(std::size_t sizeClass)
+        {
+            const std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Private::CCallbackBlock*& freeHead = m_FreeBlocks[sizeClass];
+            if (!freeHead)
+            {
+                const std::size_t blockSize = Private::CCallbackBlockSizeClasses[sizeClass];
+                m_Slabs.push_back(std::make_unique<std::byte[]>(blockSize * Private::CCallbackBlocksPerSlab));
+
+                std::byte* const slab = m_Slabs.back().get();
+                for (std::size_t i = Private::CCallbackBlocksPerSlab; i-- > 0;)
+                {
+                    Private::CCallbackBlock* const block = ::new (static_cast<void*>(slab + i * blockSize)) Private::CCallbackBlock();
+                    block->m_Next = freeHead;
+                    freeHead = block;
+                }
+            }
+
+            Private::CCallbackBlock* const block = freeHead;
+            freeHead = block->m_Next;
+            ++m_AllocatedCount;
+
+            return block;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns "block" (whose callable was destroyed, or
+        // never constructed) to its free list
+        ///////////////////////////////////////////////////////
+        void Free(void* block, std::size_t sizeClass) noexcept
+        {
+            const std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Private::CCallbackBlock*& freeHead = m_FreeBlocks[sizeClass];
+            freeHead = ::new (block) Private::CCallbackBlock{freeHead};
+            --m_AllocatedCount;
+        }
+
+        mutable std::mutex m_Mutex;
+        std::size_t m_AllocatedCount = 0;
+        std::array<Private::CCallbackBlock*, Private::CCallbackBlockSizeClasses.size()> m_FreeBlocks{};
+        std::vector<std::unique_ptr<std::byte[]>> m_Slabs;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // CCallback. Owns a callable stored in a "CCallbackPool", callable from C
+    // via "GetFunction()" (a function pointer of type "Function_t") passed
+    // "GetUserData()". Normally created via "MakeCCallback()" below. See top
+    // of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename CSignatureT,
+              std::size_t UserDataIndexV = 0>
+    class CCallback
+    {
+        static_assert(Private::IsValidCSignature<CSignatureT>());
+        static_assert(UserDataIndexV <= ArgCount_v<CSignatureT>,
+                      "\"UserDataIndexV\" must be less than or equal to the arg count of \"CSignatureT\"");
+
+        using CFunctionT = typename Private::CCallbackFunction<std::remove_pointer_t<CSignatureT>, UserDataIndexV>::Type;
+        using TrampolineT = Private::CCallbackTrampoline<ReturnType_t<CFunctionT>, ArgTypes_t<CFunctionT>, UserDataIndexV>;
+        using Destroy_t = void (*)(void* userData, CCallbackPool& pool);
+
+    public:
+        using Function_t = CFunctionT*;
+
+        CCallback() noexcept = default;
+
+        template <typename CallableT>
+        CCallback(CCallbackPool& pool, CallableT&& callable)
+            : m_Pool(&pool)
+        {
+            using StoredCallableT = std::decay_t<CallableT>;
+
+            constexpr std::size_t sizeClass = Private::GetCCallbackSizeClass<StoredCallableT>();
+            static_assert(sizeClass < Private::CCallbackBlockSizeClasses.size(),
+                          "Callable passed to \"MakeCCallback()\" is too large or over-aligned "
+                          "(capture large state by pointer instead)");
+            static_assert(Private::IsCCallbackCallable<StoredCallableT, ReturnType_t<CSignatureT>, ArgTypes_t<CSignatureT>>::value,
+                          "Callable passed to \"MakeCCallback()\" can't be called with the args of \"CSignatureT\" "
+                          "(or its return type isn't convertible to the return type of \"CSignatureT\")");
+
+            m_UserData = pool.Allocate(sizeClass);
+            try
+            {
+                ::new (m_UserData) StoredCallableT(std::forward<CallableT>(callable));
+            }
+            catch (...)
+            {
+                pool.Free(m_UserData, sizeClass);
+                throw;
+            }
+
+            m_Function = &TrampolineT::template Invoke<StoredCallableT>;
+            m_Destroy = &Destroy<StoredCallableT>;
+        }
+
+        CCallback(CCallback&& other) noexcept
+            : m_Function(std::exchange(other.m_Function, nullptr)),
+              m_UserData(std::exchange(other.m_UserData, nullptr)),
+              m_Destroy(std::exchange(other.m_Destroy, nullptr)),
+              m_Pool(std::exchange(other.m_Pool, nullptr))
+        {
+        }
+
+        CCallback& operator=(CCallback&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_Function = std::exchange(other.m_Function, nullptr);
+                m_UserData = std::exchange(other.m_UserData, nullptr);
+                m_Destroy = std::exchange(other.m_Destroy, nullptr);
+                m_Pool = std::exchange(other.m_Pool, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~CCallback()
+        {
+            Reset();
+        }
+
+        ///////////////////////////////////////////////////////
+        // Trampoline to register with the C library (along
+        // with "GetUserData()"), or null if empty
+        ///////////////////////////////////////////////////////
+        Function_t GetFunction() const noexcept
+        {
+            return m_Function;
+        }
+
+        // The stored callable (passed to the trampoline), or null if empty
+        void* GetUserData() const noexcept
+        {
+            return m_UserData;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_UserData != nullptr;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Destroys the callable, returning its block to its
+        // pool (so the C library must no longer call the
+        // callback). No-op if empty.
+        ///////////////////////////////////////////////////////
+        void Reset() noexcept
+        {
+            if (m_UserData)
+            {
+                m_Destroy(m_UserData, *m_Pool);
+                m_Function = nullptr;
+                m_UserData = nullptr;
+                m_Destroy = nullptr;
+                m_Pool = nullptr;
+            }
+        }
+
+    private:
+        template <typename CallableT>
+        static void Destroy(void* userData, CCallbackPool& pool) noexcept
+        {
+            static_cast<CallableT*>(userData)->~CallableT();
+            pool.Free(userData, Private::GetCCallbackSizeClass<CallableT>());
+        }
+
+        Function_t m_Function = nullptr;
+        void* m_UserData = nullptr;
+        Destroy_t m_Destroy = nullptr;
+        CCallbackPool* m_Pool = nullptr;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeCCallback(). Returns a "CCallback" storing "callable" in "pool",
+    // whose "GetFunction()" is a C callback with signature "CSignatureT" plus
+    // a "void*" user data arg at index "UserDataIndexV" (to be passed
+    // "GetUserData()"). See top of this file for details.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename CSignatureT,
+              std::size_t UserDataIndexV = 0,
+              typename CallableT>
+    CCallback<CSignatureT, UserDataIndexV> MakeCCallback(CCallbackPool& pool, CallableT&& callable)
+    {
+        return CCallback<CSignatureT, UserDataIndexV>(pool, std::forward<CallableT>(callable));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Same as above but stores "callable" in the default pool
+    // ("CCallbackPool::GetDefault()")
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename CSignatureT,
+              std::size_t UserDataIndexV = 0,
+              typename CallableT>
+    CCallback<CSignatureT, UserDataIndexV> MakeCCallback(CallableT&& callable)
+    {
+        return CCallback<CSignatureT, UserDataIndexV>(CCallbackPool::GetDefault(), std::forward<CallableT>(callable));
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER && defined(FUNCTION_WRITE_TRAITS_SUPPORTED)
+
+#endif // #ifndef C_CALLBACK (#include guard)
@@ -0,0 +1,426 @@
+#ifndef COALESCER
+#define COALESCER
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Coalescer", which buffers calls
+// to a function of type "F" (from any number of threads) and passes them
+// in batches to a (user-supplied) function of type "BatchF" that
+// processes many calls at once, e.g.:
+//
+//     auto upserts = MakeCoalescer<void (std::string key, std::int64_t value)>(
+//                        [&](std::span<std::string> keys, std::span<std::int64_t> values)
+//                        {
+//                            db.UpsertMany(keys, values); // One round trip
+//                        });
+//
+//     // Any thread
+//     upserts("hits", 1); // Or "upserts.Call("hits", 1)"
+//
+// The args of each call are stored by value (their decayed types, given by
+// "ArgTypes_t<F>", see "FunctionTraits.h") in a struct-of-arrays buffer,
+// one contiguous column per arg, so a batch is passed to "BatchF" as one
+// "std::span" per arg (C++20 or later, otherwise as the batch's size
+// followed by a pointer to the first element of each column, e.g.,
+// "(std::size_t count, std::string* keys, std::int64_t* values)",
+// whichever "BatchF" accepts). Elements may be moved from by "BatchF".
+//
+// Buffering is lock-free: a call claims a slot in the current buffer
+// through a single atomic increment, constructs its args in place and
+// publishes them through a second atomic increment (the buffers are
+// allocated once, so no allocation per call). There are two buffers: a
+// background thread swaps them, waits for any calls still writing to the
+// old one, then passes its contents to "BatchF" while new calls fill the
+// other buffer. (Args whose construction may throw are constructed before
+// claiming a slot, then moved into it.) A batch is flushed as soon as it
+// holds "CoalescerOptions::m_MaxBatchSize" calls or when
+// "CoalescerOptions::m_MaxDelay" has elapsed (whichever comes first), or
+// when "Flush()" is called. Calls made while both buffers are in use (the
+// current one full and the other one still being processed) yield until
+// space is available (applying back pressure to callers).
+//
+// "BatchF" is called on the background thread (or by "Flush()"), one
+// batch at a time, and must not throw ("std::terminate()" is called if it
+// does). Pending calls are flushed before the destructor returns (after
+// which making more calls is undefined behavior).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+    #include <mutex>
+    #include <new>
+    #include <thread>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #if CPP20_OR_LATER
+        #include <span>
+    #endif
+#endif
+
+namespace StdExt
+{
+    /////////////////////////////////////////////////////////////////////////
+    // CoalescerOptions. Optional "Coalescer" constructor arg
+    /////////////////////////////////////////////////////////////////////////
+    struct CoalescerOptions
+    {
+        std::size_t m_MaxBatchSize = 1024; // Calls per batch (and per buffer)
+        std::chrono::microseconds m_MaxDelay{1000}; // Max time a call is buffered (roughly)
+    };
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Buffer of calls (see top of file). One column per arg
+        // type in "Ts" (all decayed), each holding "capacity"
+        // (uninitialized) elements. Each buffer on its own cache
+        // line(s) so the two don't falsely share.
+        ////////////////////////////////////////////////////////////
+        template <typename... Ts>
+        struct alignas(64) CoalescerBuffer
+        {
+            explicit CoalescerBuffer(std::size_t capacity)
+                : m_Columns(std::allocator<Ts>().allocate(capacity)...),
+                  m_Capacity(capacity)
+            {
+            }
+
+            CoalescerBuffer(const CoalescerBuffer&) = delete;
+            CoalescerBuffer& operator=(const CoalescerBuffer&) = delete;
+
+            ~CoalescerBuffer()
+            {
+                std::apply([this](Ts*... columns)
+                           {
+                               (std::allocator<Ts>().deallocate(columns, m_Capacity), ...);
+                           },
+                           m_Columns);
+            }
+
+            std::tuple<Ts*...> m_Columns;
+            std::size_t m_Capacity;
+            std::atomic<std::size_t> m_CommittedCount{0}; // Calls whose args have been fully constructed
+        };
+
+        ////////////////////////////////////////////////////////////
+        // "Coalescer" (declared after this namespace), specialized
+        // on the arg types of "F" so "Call()" takes them by their
+        // exact (declared) types
+        ////////////////////////////////////////////////////////////
+        template <typename BatchF,
+                  typename ArgTypesTupleT>
+        class CoalescerBase;
+
+        template <typename BatchF,
+                  typename... ArgsT>
+        class CoalescerBase<BatchF, std::tuple<ArgsT...>>
+        {
+            using Buffer_t = CoalescerBuffer<std::decay_t<ArgsT>...>;
+
+            /////////////////////////////////////////////////////////
+            // Current state, the index of the buffer being filled
+            // (top bit) and the number of slots claimed in it so
+            // far (remaining bits, possibly exceeding its capacity
+            // when full)
+            /////////////////////////////////////////////////////////
+            static constexpr std::uint64_t BufferIndexBit_v = std::uint64_t{1} << 63;
+
+        public:
+            CoalescerBase(BatchF batchFunction, const CoalescerOptions& options)
+                : m_BatchFunction(std::move(batchFunction)),
+                  m_MaxDelay(options.m_MaxDelay),
+                  m_Buffers{std::make_unique<Buffer_t>(options.m_MaxBatchSize == 0 ? 1 : options.m_MaxBatchSize),
+                            std::make_unique<Buffer_t>(options.m_MaxBatchSize == 0 ? 1 : options.m_MaxBatchSize)}
+            {
+                m_Flusher = std::thread(&CoalescerBase::RunFlusher, this);
+            }
+
+            CoalescerBase(const CoalescerBase&) = delete;
+            CoalescerBase& operator=(const CoalescerBase&) = delete;
+
+            ~CoalescerBase()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_WakeUpMutex);
+                    m_Stop = true;
+                }
+                m_WakeUp.notify_one();
+                m_Flusher.join();
+
+                Flush();
+            }
+
+            ///////////////////////////////////////////////////
+            // Buffers a call with "args" (callable from any
+            // thread). Lock-free unless both buffers are in use
+            // (see top of file).
+            ///////////////////////////////////////////////////
+            void Call(ArgsT... args)
+            {
+                ClaimAndConstruct(std::forward<ArgsT>(args)...);
+            }
+
+            void operator()(ArgsT... args)
+            {
+                Call(std::forward<ArgsT>(args)...);
+            }
+
+            ///////////////////////////////////////////////////
+            // Passes the calls buffered so far to "BatchF" (on
+            // the calling thread), returning their number
+            ///////////////////////////////////////////////////
+            std::size_t Flush() noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_FlushMutex);
+
+                if ((m_State.load() & ~BufferIndexBit_v) == 0)
+                {
+                    return 0;
+                }
+
+                //////////////////////////////////////////////
+                // Swaps buffers (the other one is empty since
+                // flushes are serialized), then waits for calls
+                // that claimed a slot in the old buffer to
+                // finish constructing their args
+                //////////////////////////////////////////////
+                const std::uint64_t state = m_State.exchange((m_State.load() & BufferIndexBit_v) ^ BufferIndexBit_v);
+                Buffer_t& buffer = *m_Buffers[state >> 63];
+
+                const std::uint64_t claimedCount = state & ~BufferIndexBit_v;
+                const std::size_t count = claimedCount < buffer.m_Capacity ? static_cast<std::size_t>(claimedCount) : buffer.m_Capacity;
+                while (buffer.m_CommittedCount.load() != count)
+                {
+                    std::this_thread::yield();
+                }
+
+                InvokeBatch(buffer, count);
+
+                std::apply([count](std::decay_t<ArgsT>*... columns)
+                           {
+                               (std::destroy_n(columns, count), ...);
+                           },
+                           buffer.m_Columns);
+                buffer.m_CommittedCount.store(0);
+
+                return count;
+            }
+
+        private:
+            static constexpr bool IsNothrowConstructible_v = (std::is_nothrow_constructible_v<std::decay_t<ArgsT>, ArgsT&&> && ...);
+
+            ///////////////////////////////////////////////////
+            // Claims a slot and constructs "args" in it. Note
+            // that a claimed slot can't be given back (the
+            // flusher waits for it), so if constructing the
+            // args may throw they're constructed beforehand
+            // (before claiming) then moved into the slot
+            ///////////////////////////////////////////////////
+            template <typename... ArgsToConstructT>
+            void ClaimAndConstruct(ArgsToConstructT&&... args)
+            {
+                if constexpr (IsNothrowConstructible_v)
+                {
+                    ClaimAndConstructImpl(std::forward<ArgsToConstructT>(args)...);
+                }
+                else
+                {
+                    static_assert((std::is_nothrow_move_constructible_v<std::decay_t<ArgsT>> && ...),
+                                  "The (decayed) arg types of \"F\" must be nothrow move constructible (or "
+                                  "nothrow constructible from the args passed)");
+
+                    std::tuple<std::decay_t<ArgsT>...> storedValues(std::forward<ArgsToConstructT>(args)...);
+                    std::apply([this](std::decay_t<ArgsT>&... values)
+                               {
+                                   ClaimAndConstructImpl(std::move(values)...);
+                               },
+                               storedValues);
+                }
+            }
+
+            template <typename... ArgsToConstructT>
+            void ClaimAndConstructImpl(ArgsToConstructT&&... args) noexcept
+            {
+                for (;;)
+                {
+                    const std::size_t capacity = m_Buffers[0]->m_Capacity;
+
+                    //////////////////////////////////////////////
+                    // Current buffer already full? Don't claim
+                    // (the count would keep growing), just wait
+                    // for the flusher to swap buffers.
+                    //////////////////////////////////////////////
+                    if ((m_State.load(std::memory_order_relaxed) & ~BufferIndexBit_v) < capacity)
+                    {
+                        const std::uint64_t state = m_State.fetch_add(1);
+                        const std::size_t slot = static_cast<std::size_t>(state & ~BufferIndexBit_v);
+                        if (slot < capacity)
+                        {
+                            Buffer_t& buffer = *m_Buffers[state >> 63];
+                            ConstructColumns(buffer, slot, std::index_sequence_for<ArgsT...>(), std::forward<ArgsToConstructT>(args)...);
+                            buffer.m_CommittedCount.fetch_add(1);
+
+                            // Just filled it?
+                            if (slot == capacity - 1)
+                            {
+                                RequestFlush();
+                            }
+
+                            return;
+                        }
+                    }
+
+                    RequestFlush();
+                    std::this_thread::yield();
+                }
+            }
+
+            template <std::size_t... Is,
+                      typename... ArgsToConstructT>
+            static void ConstructColumns(Buffer_t& buffer, std::size_t slot, std::index_sequence<Is...>, ArgsToConstructT&&... args) noexcept
+            {
+                (::new (static_cast<void*>(std::get<Is>(buffer.m_Columns) + slot)) std::decay_t<ArgsT>(std::forward<ArgsToConstructT>(args)), ...);
+            }
+
+            void InvokeBatch(Buffer_t& buffer, std::size_t count) noexcept
+            {
+                std::apply([this, count](std::decay_t<ArgsT>*... columns)
+                           {
+                            #if CPP20_OR_LATER
+                               if constexpr (std::is_invocable_v<BatchF&, std::span<std::decay_t<ArgsT>>...>)
+                               {
+                                   m_BatchFunction(std::span<std::decay_t<ArgsT>>(columns, count)...);
+                               }
+                               else
+                            #endif
+                               {
+                                   static_assert(std::is_invocable_v<BatchF&, std::size_t, std::decay_t<ArgsT>*...>,
+                                                 "\"BatchF\" must be callable with a batch, i.e., with a "
+                                                 "\"std::span\" of each (decayed) arg type of \"F\" (C++20 or "
+                                                 "later), or with the number of calls followed by a pointer to "
+                                                 "each (decayed) arg type of \"F\"");
+
+                                   m_BatchFunction(count, columns...);
+                               }
+                           },
+                           buffer.m_Columns);
+            }
+
+            void RequestFlush() noexcept
+            {
+                if (!m_IsFlushRequested.exchange(true))
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_WakeUpMutex);
+                    }
+                    m_WakeUp.notify_one();
+                }
+            }
+
+            void RunFlusher() noexcept
+            {
+                std::unique_lock<std::mutex> lock(m_WakeUpMutex);
+                while (!m_Stop)
+                {
+                    m_WakeUp.wait_for(lock, m_MaxDelay, [this] { return m_IsFlushRequested.load() || m_Stop; });
+                    m_IsFlushRequested.store(false);
+
+                    lock.unlock();
+                    Flush();
+                    lock.lock();
+                }
+            }
+
+            BatchF m_BatchFunction;
+            std::chrono::microseconds m_MaxDelay;
+            std::unique_ptr<Buffer_t> m_Buffers[2];
+            alignas(64) std::atomic<std::uint64_t> m_State{0}; // See "BufferIndexBit_v"
+            alignas(64) std::atomic<bool> m_IsFlushRequested{false};
+            std::mutex m_FlushMutex;
+            std::mutex m_WakeUpMutex;
+            std::condition_variable m_WakeUp;
+            bool m_Stop = false; // Guarded by "m_WakeUpMutex"
+            std::thread m_Flusher;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Coalescer. Buffers calls to a function of type "F" and passes them in
+    // batches to "BatchF". Normally created via "MakeCoalescer()" below. See
+    // top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F,
+              typename BatchF>
+    class Coalescer : public Private::CoalescerBase<BatchF, ArgTypes_t<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(std::is_void_v<ReturnType_t<F>>, "\"F\" must return \"void\" (calls are buffered)");
+        static_assert(ArgCount_v<F> != 0 && !IsVariadic_v<F>, "\"F\" must take at least one arg and can't be variadic");
+
+        using BaseClass = Private::CoalescerBase<BatchF, ArgTypes_t<F>>;
+
+    public:
+        explicit Coalescer(BatchF batchFunction, const CoalescerOptions& options = CoalescerOptions())
+            : BaseClass(std::move(batchFunction), options)
+        {
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeCoalescer(). Returns a "Coalescer" buffering calls to a function of
+    // type "F" and passing them in batches to "batchFunction".
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename BatchF>
+    Coalescer<F, std::decay_t<BatchF>> MakeCoalescer(BatchF&& batchFunction, const CoalescerOptions& options = CoalescerOptions())
+    {
+        return Coalescer<F, std::decay_t<BatchF>>(std::forward<BatchF>(batchFunction), options);
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef COALESCER (#include guard)
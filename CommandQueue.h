@@ -0,0 +1,645 @@
+#ifndef COMMAND_QUEUE
+#define COMMAND_QUEUE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "CommandQueue", a lock-free queue
+// of deferred calls ("commands") to functions of any signature, stored
+// inline in a contiguous ring buffer so pushing a command never allocates
+// (unlike the usual "std::queue<std::function<void()>>"):
+//
+//     void Log(Level level, int code, double value);
+//
+//     SpscCommandQueue queue(64 * 1024); // Ring buffer of 64K bytes
+//
+//     // Producer thread
+//     queue.Push<&Log>(Level::Info, 42, 3.14);
+//     queue.Push<&Renderer::Draw>(&renderer, x, y); // Member function
+//     queue.Push([this] { Flush(); }); // Functor (taking no args)
+//
+//     // Consumer thread
+//     queue.Drain(); // Invokes all commands pushed so far, in order
+//
+// Each command is stored as a packet consisting of a small header (a
+// pointer to a function that invokes and destroys the command, and the
+// packet's size) followed by the command's args, captured in a
+// "DeferredCall" (see "DeferredCall.h") whose padding-free layout and
+// size are computed from "FunctionTraits" (see "FunctionTraits.h") at
+// compile time. No type erasure beyond that one function pointer is
+// required since the function itself is a template arg of "Push()" (so
+// the call is direct). Packets never wrap around the end of the buffer
+// (a padding packet fills the remainder when required) and are aligned
+// to CommandPacketAlignment bytes (16).
+//
+// "SpscCommandQueue" supports a single producer thread and a single
+// consumer thread, synchronized via two atomic counters (each on its own
+// cache line). "MpscCommandQueue" supports any number of producer threads
+// (and a single consumer thread), which reserve space for their packets
+// via a CAS loop on a shared counter and publish each packet via its own
+// "ready" flag (so producers never wait for each other). In both, the
+// consumer drains commands in batches, publishing the space it frees once
+// per batch rather than once per command.
+//
+// "TryPush()" returns false if the buffer is full, while "Push()" yields
+// until space is available. Both throw "std::length_error" if the packet
+// is larger than half the buffer (a larger packet may never fit, even in
+// an empty buffer, since packets never wrap around the end of the buffer
+// and the padding before it can take the rest). If a command throws,
+// "Drain()" propagates the exception after consuming that command (so
+// the remaining commands are processed by the next call). Commands still
+// queued on destruction are destroyed without being invoked.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "DeferredCall.h" #includes "FunctionTraits.h", which
+// #includes "CompilerVersions.h" so all C++ version constants
+// such as CPP17_OR_LATER (tested just below) are available
+// after the following
+////////////////////////////////////////////////////////////////
+#include "DeferredCall.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <limits>
+    #include <memory>
+    #include <new>
+    #include <stdexcept>
+    #include <thread>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    ////////////////////////////////////////////////////////////////
+    // Alignment (and size granularity) of all packets in a
+    // "CommandQueue". Commands (their args or functor) can't
+    // require a larger alignment.
+    ////////////////////////////////////////////////////////////////
+    inline constexpr std::size_t CommandPacketAlignment = 16;
+
+    enum class CommandQueueProducers
+    {
+        Single,
+        Multiple
+    };
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Invokes the command at "payload" if "invoke" is true and
+        // destroys it in either case
+        ////////////////////////////////////////////////////////////
+        using CommandThunk_t = void (*)(void* payload, bool invoke);
+
+        struct alignas(CommandPacketAlignment) CommandPacketHeader
+        {
+            CommandThunk_t m_Thunk; // Null for padding packets
+            std::uint32_t m_Size; // Of the entire packet (header included)
+        };
+
+        constexpr std::size_t GetCommandPacketSize(std::size_t payloadSize) noexcept
+        {
+            return sizeof(CommandPacketHeader) +
+                   (payloadSize + CommandPacketAlignment - 1) / CommandPacketAlignment * CommandPacketAlignment;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Destroys "payload" on scope exit (even if invoking it
+        // throws)
+        ////////////////////////////////////////////////////////////
+        template <typename PayloadT>
+        struct CommandPayloadGuard
+        {
+            ~CommandPayloadGuard()
+            {
+                m_Payload->~PayloadT();
+            }
+
+            PayloadT* m_Payload;
+        };
+
+        template <auto FunctionV>
+        void FreeFunctionCommandThunk(void* payload, bool invoke)
+        {
+            using PayloadT = DeferredCall<std::remove_const_t<decltype(FunctionV)>>;
+            const CommandPayloadGuard<PayloadT> guard{static_cast<PayloadT*>(payload)};
+            if (invoke)
+            {
+                std::move(*guard.m_Payload).Invoke(FunctionV);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Payload of "Push<&C::M>(object, args...)" (the object
+        // pointer followed by the args)
+        ////////////////////////////////////////////////////////////
+        template <auto MemberFunctionV>
+        struct MemberFunctionCommand
+        {
+            using MemberFunction_t = std::remove_const_t<decltype(MemberFunctionV)>;
+            using Object_t = std::add_pointer_t<MemberFunctionClass_t<MemberFunction_t>>;
+
+            template <typename... ArgsT>
+            explicit MemberFunctionCommand(Object_t object, ArgsT&&... args)
+                : m_Object(object),
+                  m_Args(std::forward<ArgsT>(args)...)
+            {
+            }
+
+            Object_t m_Object;
+            DeferredCall<MemberFunction_t> m_Args;
+        };
+
+        template <auto MemberFunctionV>
+        void MemberFunctionCommandThunk(void* payload, bool invoke)
+        {
+            using PayloadT = MemberFunctionCommand<MemberFunctionV>;
+            const CommandPayloadGuard<PayloadT> guard{static_cast<PayloadT*>(payload)};
+            if (invoke)
+            {
+                std::move(guard.m_Payload->m_Args).Invoke(MemberFunctionV, guard.m_Payload->m_Object);
+            }
+        }
+
+        template <typename FunctorT>
+        void FunctorCommandThunk(void* payload, bool invoke)
+        {
+            const CommandPayloadGuard<FunctorT> guard{static_cast<FunctorT*>(payload)};
+            if (invoke)
+            {
+                (*guard.m_Payload)();
+            }
+        }
+
+        //////////////////////////////////////////////////////////////
+        // Ring buffer storage (and packet access) common to both
+        // queue variants. Positions are 64 bit counters that only
+        // increase (so never wrap in practice), reduced modulo the
+        // capacity (a power of 2) to obtain buffer offsets.
+        //////////////////////////////////////////////////////////////
+        class CommandRing
+        {
+        public:
+            explicit CommandRing(std::size_t capacity)
+                : m_Capacity(RoundUpCapacity(capacity)),
+                  m_Chunks(std::make_unique<Chunk[]>(m_Capacity / CommandPacketAlignment))
+            {
+                if (m_Capacity > std::numeric_limits<std::uint32_t>::max())
+                {
+                    throw std::length_error("CommandQueue capacity exceeds 4GB");
+                }
+            }
+
+            std::size_t GetCapacity() const noexcept
+            {
+                return m_Capacity;
+            }
+
+            std::size_t GetOffset(std::uint64_t position) const noexcept
+            {
+                return static_cast<std::size_t>(position) & (m_Capacity - 1);
+            }
+
+            CommandPacketHeader* GetHeader(std::uint64_t position) const noexcept
+            {
+                return std::launder(reinterpret_cast<CommandPacketHeader*>(GetBytes(position)));
+            }
+
+            ////////////////////////////////////////////////////
+            // Number of bytes to skip (via a padding packet) so
+            // a packet of "size" bytes starting at "position"
+            // doesn't wrap around the end of the buffer
+            ////////////////////////////////////////////////////
+            std::size_t GetPaddingSize(std::uint64_t position, std::size_t size) const noexcept
+            {
+                const std::size_t contiguous = m_Capacity - GetOffset(position);
+                return size > contiguous ? contiguous : 0;
+            }
+
+            ////////////////////////////////////////////////////
+            // Packets up to half the capacity always fit in an
+            // empty buffer (any padding required before them
+            // is smaller than they are). Larger ones may not
+            // fit at any offset they can end up at.
+            ////////////////////////////////////////////////////
+            void CheckPacketSize(std::size_t size) const
+            {
+                if (size > m_Capacity / 2)
+                {
+                    throw std::length_error("Command too large for CommandQueue");
+                }
+            }
+
+            void WritePadding(std::uint64_t position, std::size_t size) noexcept
+            {
+                ::new (static_cast<void*>(GetBytes(position))) CommandPacketHeader{nullptr, static_cast<std::uint32_t>(size)};
+            }
+
+            ////////////////////////////////////////////////////
+            // Constructs a packet for "PayloadT" (constructed
+            // from "args") at "position"
+            ////////////////////////////////////////////////////
+            template <typename PayloadT, typename... ArgsT>
+            void WritePacket(std::uint64_t position, std::size_t size, CommandThunk_t thunk, ArgsT&&... args)
+            {
+                unsigned char* const bytes = GetBytes(position);
+                ::new (static_cast<void*>(bytes + sizeof(CommandPacketHeader))) PayloadT(std::forward<ArgsT>(args)...);
+                ::new (static_cast<void*>(bytes)) CommandPacketHeader{thunk, static_cast<std::uint32_t>(size)};
+            }
+
+            ////////////////////////////////////////////////////
+            // Invokes (or just destroys if "invoke" is false)
+            // the packet at "position" (if not a padding
+            // packet), returning its size
+            ////////////////////////////////////////////////////
+            std::size_t ConsumePacket(std::uint64_t position, bool invoke) const
+            {
+                const CommandPacketHeader* const header = GetHeader(position);
+                const std::size_t size = header->m_Size;
+                if (header->m_Thunk)
+                {
+                    header->m_Thunk(GetBytes(position) + sizeof(CommandPacketHeader), invoke);
+                }
+
+                return size;
+            }
+
+        private:
+            struct alignas(CommandPacketAlignment) Chunk
+            {
+                unsigned char m_Bytes[CommandPacketAlignment];
+            };
+
+            static std::size_t RoundUpCapacity(std::size_t capacity) noexcept
+            {
+                std::size_t roundedCapacity = CommandPacketAlignment * 4;
+                while (roundedCapacity < capacity)
+                {
+                    roundedCapacity <<= 1;
+                }
+
+                return roundedCapacity;
+            }
+
+            unsigned char* GetBytes(std::uint64_t position) const noexcept
+            {
+                return m_Chunks[GetOffset(position) / CommandPacketAlignment].m_Bytes;
+            }
+
+            std::size_t m_Capacity;
+            std::unique_ptr<Chunk[]> m_Chunks;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Size of the packet for payload "PayloadT" (and compile
+        // time checks common to all payloads)
+        ////////////////////////////////////////////////////////////
+        template <typename PayloadT>
+        inline constexpr std::size_t CommandPacketSize_v = []
+        {
+            static_assert(alignof(PayloadT) <= CommandPacketAlignment,
+                          "Command args (or functor) can't require an alignment larger than CommandPacketAlignment");
+            return GetCommandPacketSize(sizeof(PayloadT));
+        }();
+
+        // Avoid false sharing between producer and consumer counters
+        inline constexpr std::size_t CommandQueueCacheLineSize = 64;
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // CommandQueue. Lock-free queue of deferred calls stored inline in a ring
+    // buffer. See top of this file for details. Use the "SpscCommandQueue"
+    // and "MpscCommandQueue" aliases below.
+    /////////////////////////////////////////////////////////////////////////////
+    template <CommandQueueProducers ProducersV>
+    class CommandQueue
+    {
+    public:
+        static constexpr bool IsMultiProducer_v = ProducersV == CommandQueueProducers::Multiple;
+
+        /////////////////////////////////////////////////////
+        // Buffer of "capacity" bytes (rounded up to a power
+        // of 2, at least 64)
+        /////////////////////////////////////////////////////
+        explicit CommandQueue(std::size_t capacity)
+            : m_Ring(capacity)
+        {
+            if constexpr (IsMultiProducer_v)
+            {
+                m_Ready = std::make_unique<std::atomic<bool>[]>(m_Ring.GetCapacity() / CommandPacketAlignment);
+                for (std::size_t i = 0; i < m_Ring.GetCapacity() / CommandPacketAlignment; ++i)
+                {
+                    m_Ready[i].store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        ~CommandQueue()
+        {
+            Consume(std::numeric_limits<std::size_t>::max(), false);
+        }
+
+        std::size_t GetCapacity() const noexcept
+        {
+            return m_Ring.GetCapacity();
+        }
+
+        ///////////////////////////////////////////////////////
+        // Queues a call to free function "FunctionV" with
+        // "args" (converted to its decayed arg types).
+        // Returns false if the buffer is full.
+        ///////////////////////////////////////////////////////
+        template <auto FunctionV, typename... ArgsT>
+        bool TryPush(ArgsT&&... args)
+        {
+            using F = std::remove_const_t<decltype(FunctionV)>;
+            if constexpr (std::is_member_function_pointer_v<F>)
+            {
+                using PayloadT = Private::MemberFunctionCommand<FunctionV>;
+                return TryWrite<PayloadT>(&Private::MemberFunctionCommandThunk<FunctionV>,
+                                          std::forward<ArgsT>(args)...);
+            }
+            else
+            {
+                static_assert(IsTraitsFreeFunction_v<F>, "\"FunctionV\" must be a pointer to a free or member function");
+
+                using PayloadT = DeferredCall<F>;
+                return TryWrite<PayloadT>(&Private::FreeFunctionCommandThunk<FunctionV>,
+                                          std::forward<ArgsT>(args)...);
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Queues a call to "functor" (invoked with no args).
+        // Returns false if the buffer is full.
+        ///////////////////////////////////////////////////////
+        template <typename F,
+                  std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>, int> = 0>
+        bool TryPush(F&& functor)
+        {
+            using PayloadT = std::decay_t<F>;
+            return TryWrite<PayloadT>(&Private::FunctorCommandThunk<PayloadT>, std::forward<F>(functor));
+        }
+
+        ///////////////////////////////////////////////////////
+        // Same as "TryPush()" above but yields until space is
+        // available (so it never returns if called by the
+        // consumer thread while the buffer is full)
+        ///////////////////////////////////////////////////////
+        template <auto FunctionV, typename... ArgsT>
+        void Push(ArgsT&&... args)
+        {
+            //////////////////////////////////////////////////
+            // Args forwarded repeatedly but only consumed
+            // (moved from) by the attempt that succeeds
+            //////////////////////////////////////////////////
+            while (!TryPush<FunctionV>(std::forward<ArgsT>(args)...))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        template <typename F,
+                  std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>, int> = 0>
+        void Push(F&& functor)
+        {
+            while (!TryPush(std::forward<F>(functor)))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Invokes (in order) up to "maxCount" queued
+        // commands, returning the number invoked. Consumer
+        // thread only.
+        ///////////////////////////////////////////////////////
+        std::size_t Drain(std::size_t maxCount = std::numeric_limits<std::size_t>::max())
+        {
+            return Consume(maxCount, true);
+        }
+
+    private:
+        template <typename PayloadT, typename... ArgsT>
+        bool TryWrite(Private::CommandThunk_t thunk, ArgsT&&... args)
+        {
+            constexpr std::size_t size = Private::CommandPacketSize_v<PayloadT>;
+            m_Ring.CheckPacketSize(size);
+
+            std::uint64_t position;
+            std::size_t padding;
+            if (!Reserve(size, position, padding))
+            {
+                return false;
+            }
+
+            if (padding != 0)
+            {
+                m_Ring.WritePadding(position, padding);
+                Publish(position);
+                position += padding;
+            }
+
+            try
+            {
+                m_Ring.WritePacket<PayloadT>(position, size, thunk, std::forward<ArgsT>(args)...);
+            }
+            catch (...)
+            {
+                ///////////////////////////////////////////////
+                // Other producers may have reserved space
+                // after ours, so the consumer must be able to
+                // skip it
+                ///////////////////////////////////////////////
+                if constexpr (IsMultiProducer_v)
+                {
+                    m_Ring.WritePadding(position, size);
+                    Publish(position);
+                }
+                throw;
+            }
+            Publish(position);
+
+            if constexpr (!IsMultiProducer_v)
+            {
+                m_Tail.store(position + size, std::memory_order_release);
+            }
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Reserves room for a packet of "size" bytes (plus
+        // any padding required before it), returning its
+        // position (that of the padding if any)
+        ///////////////////////////////////////////////////////
+        bool Reserve(std::size_t size, std::uint64_t& position, std::size_t& padding) noexcept
+        {
+            if constexpr (IsMultiProducer_v)
+            {
+                position = m_Reserve.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    padding = m_Ring.GetPaddingSize(position, size);
+                    const std::uint64_t head = m_Head.load(std::memory_order_acquire);
+
+                    ///////////////////////////////////////////////
+                    // "position" is stale if other producers and
+                    // the consumer moved past it since it was read
+                    // (so the subtraction below would wrap), in
+                    // which case reload it and retry. Otherwise
+                    // the packet doesn't fit even at the latest
+                    // position (which can only be later).
+                    ///////////////////////////////////////////////
+                    if (head > position)
+                    {
+                        position = m_Reserve.load(std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (position + padding + size - head > m_Ring.GetCapacity())
+                    {
+                        return false;
+                    }
+
+                    if (m_Reserve.compare_exchange_weak(position, position + padding + size, std::memory_order_relaxed))
+                    {
+                        return true;
+                    }
+                }
+            }
+            else
+            {
+                position = m_Tail.load(std::memory_order_relaxed);
+                padding = m_Ring.GetPaddingSize(position, size);
+
+                /////////////////////////////////////////////////
+                // Only reload the consumer's head (a cache
+                // miss) if the cached value shows no room
+                /////////////////////////////////////////////////
+                if (position + padding + size - m_CachedHead > m_Ring.GetCapacity())
+                {
+                    m_CachedHead = m_Head.load(std::memory_order_acquire);
+                    if (position + padding + size - m_CachedHead > m_Ring.GetCapacity())
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Makes the packet at "position" visible to the
+        // consumer (the single producer variant publishes its
+        // tail instead, once all its packets are written)
+        ///////////////////////////////////////////////////////
+        void Publish([[maybe_unused]] std::uint64_t position) noexcept
+        {
+            if constexpr (IsMultiProducer_v)
+            {
+                m_Ready[m_Ring.GetOffset(position) / CommandPacketAlignment].store(true, std::memory_order_release);
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns true if a packet is available at "position"
+        // ("tail" is the single producer's published tail)
+        ///////////////////////////////////////////////////////
+        bool IsAvailable(std::uint64_t position, [[maybe_unused]] std::uint64_t tail) noexcept
+        {
+            if constexpr (IsMultiProducer_v)
+            {
+                std::atomic<bool>& ready = m_Ready[m_Ring.GetOffset(position) / CommandPacketAlignment];
+                if (!ready.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+
+                // Reset for the packet that will eventually reuse this position (published via "m_Head" below)
+                ready.store(false, std::memory_order_relaxed);
+                return true;
+            }
+            else
+            {
+                return position != tail;
+            }
+        }
+
+        std::size_t Consume(std::size_t maxCount, bool invoke)
+        {
+            std::uint64_t head = m_Head.load(std::memory_order_relaxed);
+            const std::uint64_t tail = IsMultiProducer_v ? 0 : m_Tail.load(std::memory_order_acquire);
+            std::size_t count = 0;
+
+            try
+            {
+                while (count < maxCount && IsAvailable(head, tail))
+                {
+                    const bool isPadding = m_Ring.GetHeader(head)->m_Thunk == nullptr;
+                    const std::uint64_t packetPosition = head;
+                    head += m_Ring.GetHeader(head)->m_Size; // Consumed even if it throws (see top of this file)
+                    m_Ring.ConsumePacket(packetPosition, invoke);
+                    count += !isPadding;
+                }
+            }
+            catch (...)
+            {
+                m_Head.store(head, std::memory_order_release);
+                throw;
+            }
+
+            // Frees the space for the entire batch at once
+            m_Head.store(head, std::memory_order_release);
+            return count;
+        }
+
+        Private::CommandRing m_Ring;
+        std::unique_ptr<std::atomic<bool>[]> m_Ready; // Multiple producers only (one flag per packet position)
+
+        // Consumer
+        alignas(Private::CommandQueueCacheLineSize) std::atomic<std::uint64_t> m_Head{0};
+
+        // Producer(s)
+        alignas(Private::CommandQueueCacheLineSize) std::atomic<std::uint64_t> m_Tail{0}; // Single producer only
+        std::atomic<std::uint64_t> m_Reserve{0}; // Multiple producers only
+        std::uint64_t m_CachedHead = 0; // Single producer only
+    };
+
+    using SpscCommandQueue = CommandQueue<CommandQueueProducers::Single>;
+    using MpscCommandQueue = CommandQueue<CommandQueueProducers::Multiple>;
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef COMMAND_QUEUE (#include guard)
@@ -0,0 +1,270 @@
+#ifndef COMPACT_MEMBER_FN_PTR
+#define COMPACT_MEMBER_FN_PTR
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "CompactMemberFnPtr", a drop-in
+// replacement for a non-static member function pointer whose target is
+// known at compile time, stored as a single (ordinary) code pointer
+// instead.
+//
+// On the Itanium C++ ABI (GCC, Clang and Intel on all non-Windows
+// platforms) a member function pointer is two words (16 bytes on 64 bit
+// platforms), a function pointer or vtable offset plus a "this" adjustment,
+// and calling one first tests whether the target is virtual (a runtime
+// branch). MSVC's member function pointers also grow beyond a single word
+// whenever multiple or virtual inheritance is involved. When the target is
+// known at compile time however, none of this is required. A
+// "CompactMemberFnPtr" is created from a member function pointer passed as
+// a template arg, e.g.:
+//
+//     class Widget
+//     {
+//     public:
+//         int Process(int);
+//     };
+//
+//     using F = decltype(&Widget::Process);
+//     constexpr auto process = CompactMemberFnPtr<F>::Make<&Widget::Process>();
+//
+//     Widget widget;
+//     process(widget, 10); // Calls "widget.Process(10)"
+//
+// It stores only a pointer to a "thunk" generated for that specific member
+// function, which in turn calls the member function directly, so any
+// "this" adjustment is folded into the thunk at compile time (normally a
+// single "add" instruction or nothing at all), and there's no virtual-bit
+// test. A "CompactMemberFnPtr" is therefore the size of a plain function
+// pointer, so tables of them are half the size of tables of member
+// function pointers on the Itanium ABI (relevant for large callback
+// tables). Note that virtual member functions are also supported but the
+// call then goes through the vtable in the thunk as usual (i.e., the
+// virtual call itself can't be avoided of course, only the runtime test
+// for it).
+//
+// The class the member function must be invoked on and its required
+// qualification (cv and ref qualifiers) are taken from the member function
+// pointer type "F" itself via "FunctionTraits" (see "FunctionTraits.h").
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// "Delegate.h" #includes "FunctionTraits.h" which #includes
+// "CompilerVersions.h" so all C++ version constants such as
+// CPP17_OR_LATER (tested just below) are available after the
+// following (we rely on "Private::DelegateObject_t" from
+// "Delegate.h" to work out the object type of a member function)
+/////////////////////////////////////////////////////////////////////
+#include "Delegate.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ///////////////////////////////////////////////////////////////
+        // CompactMemberFnPtrBase. Implementation of
+        // "CompactMemberFnPtr" (declared after this namespace),
+        // specialized on the arg types of member function pointer
+        // type "F" so that "operator()" takes them by their exact
+        // (declared) types. "ObjectRefT" is the reference type the
+        // member function is invoked on ("ObjectT &", or "ObjectT &&"
+        // if the member function has the "&&" ref-qualifier).
+        ///////////////////////////////////////////////////////////////
+        template <typename F,
+                  typename ObjectRefT,
+                  typename ArgTypesTupleT>
+        class CompactMemberFnPtrBase;
+
+        template <typename F,
+                  typename ObjectRefT,
+                  typename... ArgsT>
+        class CompactMemberFnPtrBase<F, ObjectRefT, std::tuple<ArgsT...>>
+        {
+        protected:
+            using R = ReturnType_t<F>;
+            static constexpr bool IsNoexcept = IsNoexcept_v<F>;
+
+        public:
+            ///////////////////////////////////////////////////////
+            // Type of our thunk (the only thing we store). Takes
+            // the object followed by the args of "F".
+            ///////////////////////////////////////////////////////
+            using Thunk_t = R (*)(ObjectRefT, ArgsT...) noexcept(IsNoexcept);
+
+            constexpr CompactMemberFnPtrBase() noexcept = default;
+
+            constexpr explicit CompactMemberFnPtrBase(Thunk_t thunk) noexcept
+                : m_Thunk(thunk)
+            {
+            }
+
+            ///////////////////////////////////////////////////////
+            // Invokes the target member function on "object",
+            // equivalent to "(object.*memberFunctionPtr)(args...)"
+            ///////////////////////////////////////////////////////
+            R operator()(ObjectRefT object, ArgsT... args) const noexcept(IsNoexcept)
+            {
+                return m_Thunk(std::forward<ObjectRefT>(object), std::forward<ArgsT>(args)...);
+            }
+
+            ///////////////////////////////////////////////////////
+            // Same as above but takes a pointer to the object
+            // instead, equivalent to
+            // "(object->*memberFunctionPtr)(args...)". Not
+            // available for "&&" member functions (which must be
+            // invoked on an rvalue).
+            ///////////////////////////////////////////////////////
+            template <typename ObjectRefU = ObjectRefT,
+                      std::enable_if_t<std::is_lvalue_reference_v<ObjectRefU>, int> = 0>
+            R operator()(std::remove_reference_t<ObjectRefU> *object, ArgsT... args) const noexcept(IsNoexcept)
+            {
+                return m_Thunk(*object, std::forward<ArgsT>(args)...);
+            }
+
+            constexpr explicit operator bool() const noexcept
+            {
+                return m_Thunk != nullptr;
+            }
+
+            constexpr Thunk_t GetThunk() const noexcept
+            {
+                return m_Thunk;
+            }
+
+            friend constexpr bool operator==(const CompactMemberFnPtrBase& ptr1, const CompactMemberFnPtrBase& ptr2) noexcept
+            {
+                return ptr1.m_Thunk == ptr2.m_Thunk;
+            }
+
+            friend constexpr bool operator!=(const CompactMemberFnPtrBase& ptr1, const CompactMemberFnPtrBase& ptr2) noexcept
+            {
+                return !(ptr1 == ptr2);
+            }
+
+        protected:
+            template <auto MemberFunctionT>
+            static R Thunk(ObjectRefT object, ArgsT... args) noexcept(IsNoexcept)
+            {
+                //////////////////////////////////////////////////////
+                // "MemberFunctionT" is a compile-time constant so
+                // this is a direct call (any "this" adjustment is
+                // resolved at compile time and no virtual-bit test
+                // takes place)
+                //////////////////////////////////////////////////////
+                return (std::forward<ObjectRefT>(object).*MemberFunctionT)(std::forward<ArgsT>(args)...);
+            }
+
+        private:
+            Thunk_t m_Thunk = nullptr;
+        };
+
+        template <typename F>
+        using CompactMemberFnPtrObjectRef_t = std::conditional_t<FunctionReference_v<F> == FunctionReference::RValue,
+                                                                 DelegateObject_t<F> &&,
+                                                                 DelegateObject_t<F> &>;
+
+        template <typename F>
+        using CompactMemberFnPtrBase_t = CompactMemberFnPtrBase<F,
+                                                                CompactMemberFnPtrObjectRef_t<F>,
+                                                                ArgTypes_t<F>>;
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // CompactMemberFnPtr. Single code pointer standing in for a non-static
+    // member function pointer of type "F" whose target is known at compile
+    // time. See top of this file for details. "F" must be a (non-static)
+    // member function pointer type (or reference to one). Create instances
+    // via the static "Make()" member, passing the member function pointer as
+    // its template arg. A default constructed instance is null (calling it is
+    // undefined behavior, the same as calling a null member function
+    // pointer). Trivially copyable and usable in constant expressions so
+    // tables of these can be built at compile time.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_MEMBER_FUNCTION_C F>
+    class CompactMemberFnPtr : public Private::CompactMemberFnPtrBase_t<RemoveCvRef_t<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_MEMBER_FUNCTION(F)
+
+        static_assert(!IsVariadic_v<F>, "Variadic member functions aren't supported by \"CompactMemberFnPtr\"");
+
+        using BaseClass = Private::CompactMemberFnPtrBase_t<RemoveCvRef_t<F>>;
+
+    public:
+        using MemberFunctionPointer_t = RemoveCvRef_t<F>;
+        using Class_t = MemberFunctionClass_t<F>;
+
+        using BaseClass::BaseClass;
+
+        ////////////////////////////////////////////////////////////
+        // Returns a "CompactMemberFnPtr" targeting
+        // "MemberFunctionT", which must be of type "F" exactly
+        // (or implicitly convertible to it such as a member
+        // function of a base class of "Class_t"). Passing a null
+        // member function pointer results in a null
+        // "CompactMemberFnPtr".
+        ////////////////////////////////////////////////////////////
+        template <MemberFunctionPointer_t MemberFunctionT>
+        static constexpr CompactMemberFnPtr Make() noexcept
+        {
+            if constexpr (MemberFunctionT == nullptr)
+            {
+                return CompactMemberFnPtr();
+            }
+            else
+            {
+                return CompactMemberFnPtr(&BaseClass::template Thunk<MemberFunctionT>);
+            }
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeCompactMemberFnPtr(). Convenience function returning
+    // "CompactMemberFnPtr<decltype(MemberFunctionT)>::Make<MemberFunctionT>()"
+    ///////////////////////////////////////////////////////////////////////////
+    template <auto MemberFunctionT>
+    constexpr auto MakeCompactMemberFnPtr() noexcept
+    {
+        static_assert(std::is_member_function_pointer_v<decltype(MemberFunctionT)>,
+                      "\"MemberFunctionT\" must be a non-static member function pointer");
+
+        return CompactMemberFnPtr<decltype(MemberFunctionT)>::template Make<MemberFunctionT>();
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef COMPACT_MEMBER_FN_PTR (#include guard)
@@ -0,0 +1,371 @@
+#ifndef COMPOSE
+#define COMPOSE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "Compose()", which fuses a
+// chain of functions (stages) into a single functor, each stage's result
+// being passed to the next, and "ComposeStream()", which applies such a
+// chain to a range of inputs, e.g.:
+//
+//     const auto normalize = Compose(&Parse,                            // Sample (std::string_view)
+//                                    [](const Sample& s) { return s.m_Value * s.m_Scale; },
+//                                    &Clamp);                           // double (double)
+//
+//     const double value = normalize(line); // Clamp(Parse(line).m_Value * ...)
+//
+//     ComposeStream(normalize, lines.begin(), lines.end(), std::back_inserter(values));
+//
+// Each stage can be a functor (including a non-generic lambda) or a
+// pointer to a free function, and is checked at compile time via
+// "FunctionTraits" (see "FunctionTraits.h"): every stage after the first
+// must take exactly one arg, which must be callable with the result
+// ("ReturnType_t") of the previous stage. The resulting functor, a
+// "Composed", has a single (non-template) "operator()" whose signature is
+// derived from the stages: it takes the arg types of the first stage
+// ("ArgTypes_t", by their exact types), returns the return type of the
+// last, and is "noexcept" if all stages are. It's available as
+// "Composed::Signature_t", and "Composed" itself is a functor supported
+// by "FunctionTraits" (so it can be composed again, or passed anywhere a
+// function is expected). Stages are stored by value and called directly
+// (as "const"), so the whole chain can be inlined (there's no type
+// erasure). Note that mutable lambdas therefore aren't supported.
+//
+// "ComposeStream()" processes the range in blocks ("BlockSizeV" inputs
+// at a time, 256 by default), running each stage over the whole block
+// before the next stage (so each stage runs in a tight loop that the
+// compiler can unroll or vectorize), with intermediate results held in
+// uninitialized stack buffers (one per intermediate stage, each
+// "BlockSizeV" results) and moved from one stage to the next. The first
+// stage must therefore take a single arg (each input), and the last
+// stage's results are written to the output iterator (unless it returns
+// "void").
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <functional>
+    #include <new>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        template <typename StageT>
+        constexpr bool IsValidComposeStage() noexcept
+        {
+            static_assert(IsTraitsFreeFunction_v<std::remove_pointer_t<StageT>> || IsTraitsFunctor_v<StageT>,
+                          "Stages passed to \"Compose()\" must be functors (non-generic lambdas included) or "
+                          "pointers to free functions");
+            static_assert(!IsVariadic_v<StageT>, "Stages passed to \"Compose()\" can't be variadic");
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Checks that stage "NextT" can be fed the result of stage
+        // "PreviousT"
+        ////////////////////////////////////////////////////////////
+        template <typename PreviousT,
+                  typename NextT>
+        constexpr bool IsComposable() noexcept
+        {
+            static_assert(ArgCount_v<NextT> == 1,
+                          "Each stage passed to \"Compose()\" (other than the first) must take exactly one arg");
+            static_assert(!std::is_void_v<ReturnType_t<PreviousT>>,
+                          "Only the last stage passed to \"Compose()\" can return \"void\"");
+            static_assert(std::is_invocable_v<const NextT&, ReturnType_t<PreviousT>>,
+                          "A stage passed to \"Compose()\" can't be called with the result of the previous stage");
+
+            return true;
+        }
+
+        template <typename... StagesT,
+                  std::size_t... Is>
+        constexpr bool IsComposable(std::index_sequence<Is...>) noexcept
+        {
+            using StagesTupleT = std::tuple<StagesT...>;
+            return (IsComposable<std::tuple_element_t<Is, StagesTupleT>, std::tuple_element_t<Is + 1, StagesTupleT>>() && ...);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // "Composed" (declared after this namespace), specialized
+        // on the arg types of its first stage so "operator()"
+        // takes them by their exact (declared) types
+        ////////////////////////////////////////////////////////////
+        template <typename ArgTypesTupleT,
+                  typename... StagesT>
+        class ComposedBase;
+
+        template <typename... ArgsT,
+                  typename... StagesT>
+        class ComposedBase<std::tuple<ArgsT...>, StagesT...>
+        {
+        public:
+            using Return_t = ReturnType_t<std::tuple_element_t<sizeof...(StagesT) - 1, std::tuple<StagesT...>>>;
+            static constexpr bool IsNoexcept_v = (StdExt::IsNoexcept_v<StagesT> && ...);
+            using Signature_t = Return_t (ArgsT...) noexcept(IsNoexcept_v);
+
+            template <typename... StagesToStoreT>
+            explicit constexpr ComposedBase(std::in_place_t, StagesToStoreT&&... stages)
+                : m_Stages(std::forward<StagesToStoreT>(stages)...)
+            {
+            }
+
+            constexpr Return_t operator()(ArgsT... args) const noexcept(IsNoexcept_v)
+            {
+                if constexpr (sizeof...(StagesT) == 1)
+                {
+                    return std::get<0>(m_Stages)(std::forward<ArgsT>(args)...);
+                }
+                else
+                {
+                    return Invoke<1>(std::get<0>(m_Stages)(std::forward<ArgsT>(args)...));
+                }
+            }
+
+            constexpr const std::tuple<StagesT...>& GetStages() const noexcept
+            {
+                return m_Stages;
+            }
+
+        private:
+            ///////////////////////////////////////////////////
+            // Passes "value" (the result of stage "I - 1") to
+            // stage "I" and so on (through the last stage)
+            ///////////////////////////////////////////////////
+            template <std::size_t I,
+                      typename T>
+            constexpr Return_t Invoke(T&& value) const noexcept(IsNoexcept_v)
+            {
+                if constexpr (I == sizeof...(StagesT) - 1)
+                {
+                    return std::get<I>(m_Stages)(std::forward<T>(value));
+                }
+                else
+                {
+                    return Invoke<I + 1>(std::get<I>(m_Stages)(std::forward<T>(value)));
+                }
+            }
+
+            std::tuple<StagesT...> m_Stages;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Uninitialized storage for up to "N" objects of type "T"
+        // (a block of intermediate results, see "ComposeStream()"),
+        // destroying those constructed
+        ////////////////////////////////////////////////////////////
+        template <typename T,
+                  std::size_t N>
+        class ComposeBlock
+        {
+        public:
+            ComposeBlock() = default;
+            ComposeBlock(const ComposeBlock&) = delete;
+            ComposeBlock& operator=(const ComposeBlock&) = delete;
+
+            ~ComposeBlock()
+            {
+                Clear();
+            }
+
+            template <typename... ArgsT>
+            void Emplace(ArgsT&&... args)
+            {
+                ::new (static_cast<void*>(m_Storage + m_Count * sizeof(T))) T(std::forward<ArgsT>(args)...);
+                ++m_Count;
+            }
+
+            T& operator[](std::size_t index) noexcept
+            {
+                return *std::launder(reinterpret_cast<T*>(m_Storage + index * sizeof(T)));
+            }
+
+            std::size_t GetCount() const noexcept
+            {
+                return m_Count;
+            }
+
+            void Clear() noexcept
+            {
+                for (std::size_t i = 0; i < m_Count; ++i)
+                {
+                    (*this)[i].~T();
+                }
+                m_Count = 0;
+            }
+
+        private:
+            alignas(T) unsigned char m_Storage[N * sizeof(T)];
+            std::size_t m_Count = 0;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Composed. Functor calling "StagesT" in turn, each passed the result of
+    // the previous one. Normally created via "Compose()" below. See top of
+    // this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename... StagesT>
+    class Composed : public Private::ComposedBase<ArgTypes_t<std::tuple_element_t<0, std::tuple<StagesT...>>>, StagesT...>
+    {
+        static_assert((Private::IsValidComposeStage<StagesT>() && ...));
+        static_assert(Private::IsComposable<StagesT...>(std::make_index_sequence<sizeof...(StagesT) - 1>()));
+
+        using BaseClass = Private::ComposedBase<ArgTypes_t<std::tuple_element_t<0, std::tuple<StagesT...>>>, StagesT...>;
+
+    public:
+        using BaseClass::BaseClass;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Compose(). Returns a "Composed" functor calling "stages" in turn, each
+    // passed the result of the previous one (i.e., "Compose(f, g, h)(args)"
+    // is "h(g(f(args)))").
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename... StagesT>
+    constexpr Composed<std::decay_t<StagesT>...> Compose(StagesT&&... stages)
+    {
+        static_assert(sizeof...(StagesT) != 0, "\"Compose()\" requires at least one stage");
+
+        return Composed<std::decay_t<StagesT>...>(std::in_place, std::forward<StagesT>(stages)...);
+    }
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Runs stage "I" (and the following stages) of "stages"
+        // over "block" (the results of stage "I - 1")
+        ////////////////////////////////////////////////////////////
+        template <std::size_t I,
+                  std::size_t BlockSizeV,
+                  typename StagesTupleT,
+                  typename BlockT,
+                  typename OutputItT>
+        OutputItT ComposeStreamBlock(const StagesTupleT& stages, BlockT& block, OutputItT out)
+        {
+            const auto& stage = std::get<I>(stages);
+
+            if constexpr (I == std::tuple_size_v<StagesTupleT> - 1)
+            {
+                for (std::size_t i = 0; i < block.GetCount(); ++i)
+                {
+                    if constexpr (std::is_void_v<ReturnType_t<RemoveCvRef_t<decltype(stage)>>>)
+                    {
+                        std::invoke(stage, std::move(block[i]));
+                    }
+                    else
+                    {
+                        *out = std::invoke(stage, std::move(block[i]));
+                        ++out;
+                    }
+                }
+
+                return out;
+            }
+            else
+            {
+                ComposeBlock<std::decay_t<ReturnType_t<RemoveCvRef_t<decltype(stage)>>>, BlockSizeV> results;
+                for (std::size_t i = 0; i < block.GetCount(); ++i)
+                {
+                    results.Emplace(std::invoke(stage, std::move(block[i])));
+                }
+                block.Clear();
+
+                return ComposeStreamBlock<I + 1, BlockSizeV>(stages, results, out);
+            }
+        }
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // ComposeStream(). Applies "composed" (returned by "Compose()") to each
+    // input in ["first", "last"), writing the results to "out" (unless the
+    // last stage returns "void"), processing "BlockSizeV" inputs at a time
+    // one stage after another. Returns the output iterator. See top of this
+    // file for details.
+    ///////////////////////////////////////////////////////////////////////////
+    template <std::size_t BlockSizeV = 256,
+              typename... StagesT,
+              typename InputItT,
+              typename OutputItT>
+    OutputItT ComposeStream(const Composed<StagesT...>& composed, InputItT first, InputItT last, OutputItT out)
+    {
+        static_assert(BlockSizeV != 0, "\"BlockSizeV\" can't be zero");
+
+        using FirstStageT = std::tuple_element_t<0, std::tuple<StagesT...>>;
+        static_assert(ArgCount_v<FirstStageT> == 1,
+                      "The first stage must take exactly one arg (each input) for \"ComposeStream()\"");
+
+        const std::tuple<StagesT...>& stages = composed.GetStages();
+
+        if constexpr (sizeof...(StagesT) == 1)
+        {
+            for (; first != last; ++first)
+            {
+                if constexpr (std::is_void_v<ReturnType_t<FirstStageT>>)
+                {
+                    std::invoke(std::get<0>(stages), *first);
+                }
+                else
+                {
+                    *out = std::invoke(std::get<0>(stages), *first);
+                    ++out;
+                }
+            }
+        }
+        else
+        {
+            while (first != last)
+            {
+                Private::ComposeBlock<std::decay_t<ReturnType_t<FirstStageT>>, BlockSizeV> block;
+                for (; first != last && block.GetCount() != BlockSizeV; ++first)
+                {
+                    block.Emplace(std::invoke(std::get<0>(stages), *first));
+                }
+
+                out = Private::ComposeStreamBlock<1, BlockSizeV>(stages, block, out);
+            }
+        }
+
+        return out;
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef COMPOSE (#include guard)
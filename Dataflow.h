@@ -0,0 +1,630 @@
+#ifndef DATAFLOW
+#define DATAFLOW
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Dataflow", a graph of functions
+// (a DAG) whose edges are inferred from their types and which is run in
+// parallel on a "ThreadPool" (see "ThreadPool.h"), e.g.:
+//
+//     Image Load();
+//     Histogram ComputeHistogram(const Image& image);
+//     Thumbnail MakeThumbnail(const Image& image);
+//     Report MakeReport(const Histogram& histogram, Thumbnail thumbnail);
+//
+//     using Pipeline = DataflowOf<&Load, &ComputeHistogram, &MakeThumbnail, &MakeReport>;
+//
+//     ThreadPool pool;
+//     auto results = Pipeline::Run(pool); // "ComputeHistogram" and "MakeThumbnail" run in parallel
+//     Report& report = results.Get<3>(); // Result of node 3 ("MakeReport")
+//
+// Each node is a free function (or static member function) and each of its
+// args is fed by the result of another node, its producer, found at
+// compile time by matching the arg's type ("ArgType_t", see
+// "FunctionTraits.h", with cv-qualifiers and references removed) to the
+// return type ("ReturnType_t") of the other nodes. Exactly one node must
+// match, otherwise the arg's producer must be given explicitly, by node
+// index, via "DataflowNode" (one index per arg):
+//
+//     using Graph = Dataflow<DataflowNode<&ReadA>,         // 0
+//                            DataflowNode<&ReadB>,         // 1 (same return type as 0)
+//                            DataflowNode<&Merge, 0, 1>>;  // 2 (first arg fed by 0, second by 1)
+//
+// ("DataflowOf<&F1, &F2, ...>" is just shorthand for
+// "Dataflow<DataflowNode<&F1>, DataflowNode<&F2>, ...>".) Missing or
+// ambiguous producers, type mismatches and cycles are all reported at
+// compile time.
+//
+// "Run()" submits each node to the pool as soon as all its producers have
+// completed (tracked by an atomic count of pending args per node, with no
+// allocation per node since each is submitted as a function pointer and
+// context, see "ThreadPool::Submit()"), and waits for all of them. Each
+// result is constructed in a slot (a "std::optional") preallocated in the
+// object "Run()" returns. A result feeding exactly one arg is moved into
+// it, otherwise it's passed as a "const" lvalue to each (copied if taken
+// by value), and remains available via "Get()" (as do the results of
+// nodes feeding no others).
+//
+// If a node throws, nodes not yet started are skipped and the (first)
+// exception is rethrown by "Run()" once running nodes have completed.
+// "Run()" must not be called from one of the pool's own worker threads
+// (it blocks until the graph completes).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "ThreadPool.h" #includes "FunctionTraits.h", which #includes
+// "CompilerVersions.h" so all C++ version constants such as
+// CPP17_OR_LATER (tested just below) are available after the
+// following
+////////////////////////////////////////////////////////////////
+#include "ThreadPool.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <exception>
+    #include <functional>
+    #include <mutex>
+    #include <optional>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    /////////////////////////////////////////////////////////////////////////
+    // DataflowNode. Node of a "Dataflow" graph calling free function
+    // "FunctionV", with the producers of its args given by node index
+    // (one per arg), or inferred if none are given. See top of this file.
+    /////////////////////////////////////////////////////////////////////////
+    template <auto FunctionV,
+              std::size_t... ProducersV>
+    struct DataflowNode
+    {
+    };
+
+    namespace Private
+    {
+        // Producer index of an arg matched by no node, or by more than one
+        inline constexpr std::size_t DataflowNoProducer = static_cast<std::size_t>(-1);
+        inline constexpr std::size_t DataflowAmbiguousProducer = static_cast<std::size_t>(-2);
+
+        // Result slot of a node returning "void"
+        struct DataflowNoResult
+        {
+        };
+
+        template <typename NodeT>
+        struct DataflowNodeTraits;
+
+        template <auto FunctionV,
+                  std::size_t... ProducersV>
+        struct DataflowNodeTraits<DataflowNode<FunctionV, ProducersV...>>
+        {
+            using Function_t = std::remove_const_t<decltype(FunctionV)>;
+
+            static_assert(IsTraitsFreeFunction_v<std::remove_pointer_t<Function_t>>,
+                          "Dataflow nodes must be (pointers to) free functions or static member functions");
+            static_assert(!IsVariadic_v<Function_t>, "Dataflow nodes can't be variadic functions");
+            static_assert(sizeof...(ProducersV) == 0 || sizeof...(ProducersV) == ArgCount_v<Function_t>,
+                          "\"DataflowNode\" must be given either no producers (inferred) or one producer per arg");
+
+            static constexpr auto Function_v = FunctionV;
+            static constexpr std::size_t ArgCount_v = StdExt::ArgCount_v<Function_t>;
+            static constexpr bool IsInferred_v = sizeof...(ProducersV) == 0;
+            static constexpr std::array<std::size_t, sizeof...(ProducersV)> Producers_v = {ProducersV...};
+
+            using Result_t = ReturnType_t<Function_t>;
+            using Slot_t = std::conditional_t<std::is_void_v<Result_t>, DataflowNoResult, std::optional<Result_t>>;
+
+            // Type of arg "I" a producer must return
+            template <std::size_t I>
+            using Arg_t = RemoveCvRef_t<ArgType_t<Function_t, I>>;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Index in "NodesT" of the only node (other than
+        // "nodeIndex") returning "T", or "DataflowNoProducer" or
+        // "DataflowAmbiguousProducer"
+        ////////////////////////////////////////////////////////////
+        template <typename T,
+                  typename... NodesT>
+        constexpr std::size_t FindDataflowProducer(std::size_t nodeIndex) noexcept
+        {
+            constexpr std::array<bool, sizeof...(NodesT)> isMatch = {std::is_same_v<typename DataflowNodeTraits<NodesT>::Result_t, T>...};
+
+            std::size_t producer = DataflowNoProducer;
+            for (std::size_t i = 0; i < isMatch.size(); ++i)
+            {
+                if (isMatch[i] && i != nodeIndex)
+                {
+                    if (producer != DataflowNoProducer)
+                    {
+                        return DataflowAmbiguousProducer;
+                    }
+
+                    producer = i;
+                }
+            }
+
+            return producer;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Producer of each arg of node "NodeIndexV" (inferred or
+        // as given by "DataflowNode"), unused entries zero
+        ////////////////////////////////////////////////////////////
+        template <std::size_t MaxArgCountV,
+                  std::size_t NodeIndexV,
+                  typename NodeTraitsT,
+                  typename... NodesT,
+                  std::size_t... ArgIs>
+        constexpr std::array<std::size_t, MaxArgCountV> GetDataflowNodeProducers(std::index_sequence<ArgIs...>) noexcept
+        {
+            std::array<std::size_t, MaxArgCountV> producers{};
+            if constexpr (NodeTraitsT::IsInferred_v)
+            {
+                ((producers[ArgIs] = FindDataflowProducer<typename NodeTraitsT::template Arg_t<ArgIs>, NodesT...>(NodeIndexV)), ...);
+            }
+            else
+            {
+                ((producers[ArgIs] = NodeTraitsT::Producers_v[ArgIs]), ...);
+            }
+
+            return producers;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Consumers of each node's result (the nodes its result
+        // feeds, once per arg fed), "m_Offsets[I]" being the index
+        // in "m_Consumers" of the first consumer of node "I"
+        ////////////////////////////////////////////////////////////
+        template <std::size_t NodeCountV,
+                  std::size_t EdgeCountV>
+        struct DataflowConsumers
+        {
+            std::array<std::size_t, NodeCountV + 1> m_Offsets{};
+            std::array<std::size_t, (EdgeCountV == 0 ? 1 : EdgeCountV)> m_Consumers{};
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Graph of nodes "NodesT". Its structure (the producer of
+        // each arg and the consumers of each result) is computed at
+        // compile time.
+        ////////////////////////////////////////////////////////////
+        template <typename... NodesT>
+        struct DataflowGraph
+        {
+            static constexpr std::size_t NodeCount_v = sizeof...(NodesT);
+            static constexpr std::size_t EdgeCount_v = (DataflowNodeTraits<NodesT>::ArgCount_v + ... + 0);
+            static constexpr std::size_t MaxArgCount_v = std::max({std::size_t{1}, DataflowNodeTraits<NodesT>::ArgCount_v...});
+
+            template <std::size_t I>
+            using Node_t = DataflowNodeTraits<std::tuple_element_t<I, std::tuple<NodesT...>>>;
+
+            static constexpr std::array<std::size_t, NodeCount_v> ArgCounts_v = {DataflowNodeTraits<NodesT>::ArgCount_v...};
+
+            using Producers_t = std::array<std::array<std::size_t, MaxArgCount_v>, NodeCount_v>;
+            using Consumers_t = DataflowConsumers<NodeCount_v, EdgeCount_v>;
+
+            template <std::size_t... Is>
+            static constexpr Producers_t GetProducers(std::index_sequence<Is...>) noexcept
+            {
+                return {GetDataflowNodeProducers<MaxArgCount_v, Is, Node_t<Is>, NodesT...>(std::make_index_sequence<Node_t<Is>::ArgCount_v>())...};
+            }
+
+            ///////////////////////////////////////////////////
+            // Returns true if each producer is a valid node
+            // index (other than the consumer's own)
+            ///////////////////////////////////////////////////
+            static constexpr bool IsValidProducers(const Producers_t& producers) noexcept
+            {
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    for (std::size_t arg = 0; arg < ArgCounts_v[node]; ++arg)
+                    {
+                        if (producers[node][arg] >= NodeCount_v || producers[node][arg] == node)
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            ///////////////////////////////////////////////////
+            // Returns true if any producer is "producer"
+            // (normally "DataflowNoProducer" or
+            // "DataflowAmbiguousProducer")
+            ///////////////////////////////////////////////////
+            static constexpr bool HasProducer(const Producers_t& producers, std::size_t producer) noexcept
+            {
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    for (std::size_t arg = 0; arg < ArgCounts_v[node]; ++arg)
+                    {
+                        if (producers[node][arg] == producer)
+                        {
+                            return true;
+                        }
+                    }
+                }
+
+                return false;
+            }
+
+            ///////////////////////////////////////////////////
+            // Returns true if each producer returns the type
+            // of the arg it feeds (always the case for
+            // inferred producers)
+            ///////////////////////////////////////////////////
+            template <std::size_t... Is>
+            static constexpr bool IsTypeMatch(const Producers_t& producers, std::index_sequence<Is...>) noexcept
+            {
+                return (IsNodeTypeMatch<Is>(producers, std::make_index_sequence<Node_t<Is>::ArgCount_v>()) && ...);
+            }
+
+            template <std::size_t I,
+                      std::size_t... ArgIs>
+            static constexpr bool IsNodeTypeMatch(const Producers_t& producers, std::index_sequence<ArgIs...>) noexcept
+            {
+                return (IsArgTypeMatch<typename Node_t<I>::template Arg_t<ArgIs>>(producers[I][ArgIs]) && ...);
+            }
+
+            template <typename ArgT>
+            static constexpr bool IsArgTypeMatch(std::size_t producer) noexcept
+            {
+                constexpr std::array<bool, NodeCount_v> isMatch = {std::is_same_v<typename DataflowNodeTraits<NodesT>::Result_t, ArgT>...};
+                return producer < NodeCount_v && isMatch[producer];
+            }
+
+            static constexpr Consumers_t GetConsumers(const Producers_t& producers) noexcept
+            {
+                Consumers_t consumers;
+                if (!IsValidProducers(producers))
+                {
+                    return consumers;
+                }
+
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    for (std::size_t arg = 0; arg < ArgCounts_v[node]; ++arg)
+                    {
+                        ++consumers.m_Offsets[producers[node][arg] + 1];
+                    }
+                }
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    consumers.m_Offsets[node + 1] += consumers.m_Offsets[node];
+                }
+
+                std::array<std::size_t, NodeCount_v> counts{};
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    for (std::size_t arg = 0; arg < ArgCounts_v[node]; ++arg)
+                    {
+                        const std::size_t producer = producers[node][arg];
+                        consumers.m_Consumers[consumers.m_Offsets[producer] + counts[producer]++] = node;
+                    }
+                }
+
+                return consumers;
+            }
+
+            ///////////////////////////////////////////////////
+            // Returns true if the graph has no cycle, i.e., all
+            // nodes can be ordered so each follows its
+            // producers (Kahn's algorithm)
+            ///////////////////////////////////////////////////
+            static constexpr bool IsAcyclic(const Consumers_t& consumers) noexcept
+            {
+                std::array<std::size_t, NodeCount_v> pendingCounts = ArgCounts_v;
+                std::array<std::size_t, NodeCount_v> ready{};
+
+                std::size_t readyCount = 0;
+                for (std::size_t node = 0; node < NodeCount_v; ++node)
+                {
+                    if (pendingCounts[node] == 0)
+                    {
+                        ready[readyCount++] = node;
+                    }
+                }
+
+                for (std::size_t i = 0; i < readyCount; ++i)
+                {
+                    const std::size_t node = ready[i];
+                    for (std::size_t c = consumers.m_Offsets[node]; c < consumers.m_Offsets[node + 1]; ++c)
+                    {
+                        if (--pendingCounts[consumers.m_Consumers[c]] == 0)
+                        {
+                            ready[readyCount++] = consumers.m_Consumers[c];
+                        }
+                    }
+                }
+
+                return readyCount == NodeCount_v;
+            }
+        };
+    } // namespace Private
+
+    template <typename... NodesT>
+    class Dataflow;
+
+    /////////////////////////////////////////////////////////////////////////
+    // DataflowResults. Result slots of the nodes of "Dataflow<NodesT...>"
+    // (as returned by its "Run()")
+    /////////////////////////////////////////////////////////////////////////
+    template <typename... NodesT>
+    class DataflowResults
+    {
+        using GraphT = Private::DataflowGraph<NodesT...>;
+
+    public:
+        ///////////////////////////////////////////////////////
+        // Result of node "I" (not available for nodes whose
+        // result feeds exactly one arg, since it's moved)
+        ///////////////////////////////////////////////////////
+        template <std::size_t I>
+        auto& Get() noexcept
+        {
+            return *GetSlot<I>();
+        }
+
+        template <std::size_t I>
+        const auto& Get() const noexcept
+        {
+            return *GetSlot<I>();
+        }
+
+    private:
+        friend class Dataflow<NodesT...>;
+
+        template <std::size_t I>
+        auto& GetSlot() noexcept
+        {
+            static_assert(!std::is_void_v<typename GraphT::template Node_t<I>::Result_t>, "Node \"I\" returns \"void\"");
+            static_assert(Dataflow<NodesT...>::template IsResultMoved_v<I> == false,
+                          "The result of node \"I\" is moved into the only arg it feeds so isn't available");
+
+            return std::get<I>(m_Slots);
+        }
+
+        template <std::size_t I>
+        const auto& GetSlot() const noexcept
+        {
+            return const_cast<DataflowResults*>(this)->GetSlot<I>();
+        }
+
+        std::tuple<typename Private::DataflowNodeTraits<NodesT>::Slot_t...> m_Slots;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Dataflow. Graph of functions "NodesT" (each a "DataflowNode") run in
+    // parallel on a "ThreadPool", each node fed the results of its producers.
+    // Stateless (all members are static). See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename... NodesT>
+    class Dataflow
+    {
+        using GraphT = Private::DataflowGraph<NodesT...>;
+        using Indexes = std::make_index_sequence<sizeof...(NodesT)>;
+
+        static_assert(sizeof...(NodesT) != 0, "\"Dataflow\" requires at least one node");
+
+        static constexpr typename GraphT::Producers_t Producers_v = GraphT::GetProducers(Indexes());
+
+        static_assert(!GraphT::HasProducer(Producers_v, Private::DataflowNoProducer),
+                      "The type of a node's arg isn't returned by any other node (its producer must be given "
+                      "explicitly via \"DataflowNode\")");
+        static_assert(!GraphT::HasProducer(Producers_v, Private::DataflowAmbiguousProducer),
+                      "The type of a node's arg is returned by more than one other node (its producer must be "
+                      "given explicitly via \"DataflowNode\")");
+        static_assert(GraphT::IsValidProducers(Producers_v),
+                      "A producer given via \"DataflowNode\" isn't a valid node index (or is the node itself)");
+        static_assert(GraphT::IsTypeMatch(Producers_v, Indexes()),
+                      "A producer given via \"DataflowNode\" doesn't return the type of the arg it feeds "
+                      "(ignoring cv-qualifiers and references)");
+
+        static constexpr typename GraphT::Consumers_t Consumers_v = GraphT::GetConsumers(Producers_v);
+
+        static_assert(GraphT::IsAcyclic(Consumers_v), "\"Dataflow\" graph has a cycle");
+
+    public:
+        using Results_t = DataflowResults<NodesT...>;
+
+        ///////////////////////////////////////////////////////
+        // True if the result of node "I" is moved into the
+        // only arg it feeds (so not available in the results)
+        ///////////////////////////////////////////////////////
+        template <std::size_t I>
+        static constexpr bool IsResultMoved_v = Consumers_v.m_Offsets[I + 1] - Consumers_v.m_Offsets[I] == 1;
+
+        ///////////////////////////////////////////////////////
+        // Runs all nodes on "pool" (see top of file), waits
+        // for them and returns their results
+        ///////////////////////////////////////////////////////
+        static Results_t Run(ThreadPool& pool)
+        {
+            RunState state(pool);
+            for (std::size_t i = 0; i < GraphT::NodeCount_v; ++i)
+            {
+                state.m_PendingCounts[i].store(GraphT::ArgCounts_v[i], std::memory_order_relaxed);
+            }
+
+            for (std::size_t i = 0; i < GraphT::NodeCount_v; ++i)
+            {
+                if (GraphT::ArgCounts_v[i] == 0)
+                {
+                    pool.Submit(GetRunNode(i), &state);
+                }
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(state.m_Mutex);
+                state.m_Done.wait(lock, [&state] { return state.m_IsDone; });
+            }
+
+            if (state.m_Exception)
+            {
+                std::rethrow_exception(state.m_Exception);
+            }
+
+            return std::move(state.m_Results);
+        }
+
+    private:
+        struct RunState
+        {
+            explicit RunState(ThreadPool& pool) noexcept
+                : m_Pool(pool)
+            {
+            }
+
+            ThreadPool& m_Pool;
+            Results_t m_Results;
+            std::array<std::atomic<std::size_t>, GraphT::NodeCount_v> m_PendingCounts; // Args not yet produced
+            std::atomic<std::size_t> m_RemainingCount{GraphT::NodeCount_v}; // Nodes not yet completed
+            std::atomic<bool> m_IsFailed{false};
+            std::exception_ptr m_Exception; // First thrown (set once, before the node completes)
+            std::mutex m_Mutex;
+            std::condition_variable m_Done;
+            bool m_IsDone = false; // Guarded by "m_Mutex"
+        };
+
+        static void (*GetRunNode(std::size_t index) noexcept)(void*)
+        {
+            static constexpr auto runNodes = GetRunNodes(Indexes());
+            return runNodes[index];
+        }
+
+        template <std::size_t... Is>
+        static constexpr std::array<void (*)(void*), sizeof...(Is)> GetRunNodes(std::index_sequence<Is...>) noexcept
+        {
+            return {&RunNode<Is>...};
+        }
+
+        ///////////////////////////////////////////////////////
+        // Runs node "I" (unless a node failed), then submits
+        // each consumer whose args have now all been produced
+        ///////////////////////////////////////////////////////
+        template <std::size_t I>
+        static void RunNode(void* context) noexcept
+        {
+            RunState& state = *static_cast<RunState*>(context);
+
+            if (!state.m_IsFailed.load())
+            {
+                try
+                {
+                    InvokeNode<I>(state, std::make_index_sequence<GraphT::template Node_t<I>::ArgCount_v>());
+                }
+                catch (...)
+                {
+                    if (!state.m_IsFailed.exchange(true))
+                    {
+                        state.m_Exception = std::current_exception();
+                    }
+                }
+            }
+
+            for (std::size_t c = Consumers_v.m_Offsets[I]; c < Consumers_v.m_Offsets[I + 1]; ++c)
+            {
+                const std::size_t consumer = Consumers_v.m_Consumers[c];
+                if (state.m_PendingCounts[consumer].fetch_sub(1) == 1)
+                {
+                    state.m_Pool.Submit(GetRunNode(consumer), context);
+                }
+            }
+
+            /////////////////////////////////////////////////
+            // Last node? Signal "Run()", while holding the
+            // lock so "state" (owned by "Run()") outlives
+            // the notification
+            /////////////////////////////////////////////////
+            if (state.m_RemainingCount.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(state.m_Mutex);
+                state.m_IsDone = true;
+                state.m_Done.notify_one();
+            }
+        }
+
+        template <std::size_t I,
+                  std::size_t... ArgIs>
+        static void InvokeNode(RunState& state, std::index_sequence<ArgIs...>)
+        {
+            using NodeT = typename GraphT::template Node_t<I>;
+
+            static_assert(std::is_invocable_v<typename NodeT::Function_t, decltype(GetInput<Producers_v[I][ArgIs]>(state))...>,
+                          "A node can't be called with its producers' results (e.g., it takes an arg by "
+                          "non-const lvalue reference, or by rvalue reference but the result feeds more "
+                          "than one arg)");
+
+            if constexpr (std::is_void_v<typename NodeT::Result_t>)
+            {
+                std::invoke(NodeT::Function_v, GetInput<Producers_v[I][ArgIs]>(state)...);
+            }
+            else
+            {
+                std::get<I>(state.m_Results.m_Slots).emplace(std::invoke(NodeT::Function_v, GetInput<Producers_v[I][ArgIs]>(state)...));
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Result of node "ProducerV" as passed to the arg it
+        // feeds (moved if it feeds only that one)
+        ///////////////////////////////////////////////////////
+        template <std::size_t ProducerV>
+        static decltype(auto) GetInput(RunState& state) noexcept
+        {
+            auto& slot = std::get<ProducerV>(state.m_Results.m_Slots);
+            if constexpr (IsResultMoved_v<ProducerV>)
+            {
+                return std::move(*slot);
+            }
+            else
+            {
+                return std::as_const(*slot);
+            }
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // DataflowOf. Shorthand for a "Dataflow" whose nodes' producers are all
+    // inferred, i.e., "Dataflow<DataflowNode<FunctionsV>...>"
+    ///////////////////////////////////////////////////////////////////////////
+    template <auto... FunctionsV>
+    using DataflowOf = Dataflow<DataflowNode<FunctionsV>...>;
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef DATAFLOW (#include guard)
@@ -0,0 +1,390 @@
+#ifndef DEFERRED_CALL
+#define DEFERRED_CALL
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "DeferredCall", which captures the
+// args of a call to a function of type "F" (any function type supported
+// by "FunctionTraits", see "FunctionTraits.h") for invoking it later, with
+// the smallest possible footprint:
+//
+//     void Draw(char layer, double x, double y, std::uint16_t color, int id);
+//
+//     DeferredCall<decltype(Draw)> call('A', 1.0, 2.0, 0xFFFF, 42);
+//     // ... later (typically after dequeuing it)
+//     call.Invoke(Draw); // Calls Draw('A', 1.0, 2.0, 0xFFFF, 42)
+//
+// The (decayed) arg types are obtained from "ArgTypes_t" and stored in a
+// single aligned byte array whose layout is computed at compile time,
+// with the args sorted by decreasing alignment (stable, so args of equal
+// alignment keep their order), which eliminates all padding between them
+// (since the size of a type is always a multiple of its alignment). Only
+// trailing padding remains (to round the total up to the largest
+// alignment). In the above example a "DeferredCall" is therefore 24 bytes
+// (2 doubles, an int, a uint16 and a char, plus 1 trailing byte), whereas
+// the equivalent "std::tuple" (or lambda capturing the same args) is
+// typically 32 bytes. The layout is available via "Size_v", "Alignment_v"
+// and "Offset_v<I>" (all "constexpr"), and "sizeof(DeferredCall<F>)" is
+// always "Size_v".
+//
+// Args are passed back in their original (parameter) order when invoked,
+// as lvalues when "Invoke()" is called on an lvalue, or moved when called
+// on an rvalue, e.g., "std::move(call).Invoke(Draw)". Leading args can
+// also be passed to "Invoke()", such as the object when "F" is a
+// non-static member function ("std::invoke()" semantics apply). If all
+// arg types are trivially copyable then so is "DeferredCall" (so queues
+// can copy it via "memcpy()").
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <functional>
+    #include <new>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Offsets of each of "Ts" (by index) when laid out in
+        // order of decreasing alignment (stable)
+        ////////////////////////////////////////////////////////////
+        template <typename... Ts>
+        constexpr std::array<std::size_t, sizeof...(Ts)> GetPackedOffsets() noexcept
+        {
+            constexpr std::size_t count = sizeof...(Ts);
+            constexpr std::array<std::size_t, count> sizes = {sizeof(Ts)...};
+            constexpr std::array<std::size_t, count> alignments = {alignof(Ts)...};
+
+            ////////////////////////////////////////////////
+            // Insertion sort of the indexes by decreasing
+            // alignment (stable, and "count" is small)
+            ////////////////////////////////////////////////
+            std::array<std::size_t, count> order{};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::size_t j = i;
+                for (; j > 0 && alignments[order[j - 1]] < alignments[i]; --j)
+                {
+                    order[j] = order[j - 1];
+                }
+                order[j] = i;
+            }
+
+            std::array<std::size_t, count> offsets{};
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                offsets[order[i]] = offset;
+                offset += sizes[order[i]];
+            }
+
+            return offsets;
+        }
+
+        template <typename... Ts>
+        constexpr std::size_t GetPackedAlignment() noexcept
+        {
+            std::size_t alignment = 1;
+            ((alignment = alignof(Ts) > alignment ? alignof(Ts) : alignment), ...);
+            return alignment;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Total size of "Ts" packed as above, rounded up to their
+        // largest alignment (and at least 1)
+        ////////////////////////////////////////////////////////////
+        template <typename... Ts>
+        constexpr std::size_t GetPackedSize() noexcept
+        {
+            constexpr std::size_t alignment = GetPackedAlignment<Ts...>();
+            constexpr std::size_t size = (std::size_t(0) + ... + sizeof(Ts));
+            return size == 0 ? 1 : (size + alignment - 1) / alignment * alignment;
+        }
+
+        template <std::size_t I, typename... Ts>
+        using PackElement_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        //////////////////////////////////////////////////////////////
+        // Byte storage for "Ts" packed as above. Specialized below
+        // for trivially copyable "Ts" (where the implicitly
+        // generated special members suffice, so the storage itself
+        // is trivially copyable).
+        //////////////////////////////////////////////////////////////
+        template <bool IsTriviallyCopyableV, typename... Ts>
+        class PackedStorage
+        {
+        public:
+            static constexpr std::size_t Size_v = GetPackedSize<Ts...>();
+            static constexpr std::size_t Alignment_v = GetPackedAlignment<Ts...>();
+            static constexpr std::array<std::size_t, sizeof...(Ts)> Offsets = GetPackedOffsets<Ts...>();
+
+            template <std::size_t I>
+            PackElement_t<I, Ts...>& Get() noexcept
+            {
+                return *std::launder(reinterpret_cast<PackElement_t<I, Ts...>*>(m_Bytes + Offsets[I]));
+            }
+
+            template <std::size_t I>
+            const PackElement_t<I, Ts...>& Get() const noexcept
+            {
+                return *std::launder(reinterpret_cast<const PackElement_t<I, Ts...>*>(m_Bytes + Offsets[I]));
+            }
+
+        protected:
+            PackedStorage() = default;
+
+            //////////////////////////////////////////////////////
+            // Constructs each element from "args" (done here and
+            // not in a derived class's constructor body so an
+            // exception never runs the destructor of the
+            // non-trivial specialization below, which would
+            // destroy elements never constructed)
+            //////////////////////////////////////////////////////
+            template <typename... ArgsT>
+            explicit PackedStorage(std::in_place_t, ArgsT&&... args)
+            {
+                Construct(std::index_sequence_for<Ts...>(), std::forward<ArgsT>(args)...);
+            }
+
+            //////////////////////////////////////////////////////
+            // Constructs each element from "args" (in parameter
+            // order), destroying those already constructed if
+            // one throws
+            //////////////////////////////////////////////////////
+            template <std::size_t... I, typename... ArgsT>
+            void Construct(std::index_sequence<I...>, ArgsT&&... args)
+            {
+                if constexpr ((std::is_nothrow_constructible_v<Ts, ArgsT&&> && ...))
+                {
+                    (::new (static_cast<void*>(m_Bytes + Offsets[I])) Ts(std::forward<ArgsT>(args)), ...);
+                }
+                else
+                {
+                    std::size_t constructed = 0;
+                    try
+                    {
+                        ((::new (static_cast<void*>(m_Bytes + Offsets[I])) Ts(std::forward<ArgsT>(args)), ++constructed), ...);
+                    }
+                    catch (...)
+                    {
+                        DestroyFirst(constructed, std::index_sequence<I...>());
+                        throw;
+                    }
+                }
+            }
+
+            alignas(Alignment_v) unsigned char m_Bytes[Size_v];
+
+        private:
+            template <std::size_t... I>
+            void DestroyFirst([[maybe_unused]] std::size_t count, std::index_sequence<I...>) noexcept
+            {
+                ((I < count ? Get<I>().~Ts() : void()), ...);
+            }
+        };
+
+        template <typename... Ts>
+        class PackedStorage<false, Ts...> : public PackedStorage<true, Ts...>
+        {
+            using Base = PackedStorage<true, Ts...>;
+            using Indexes = std::index_sequence_for<Ts...>;
+
+        public:
+            PackedStorage(const PackedStorage& other)
+            {
+                CopyConstruct(other, Indexes());
+            }
+
+            PackedStorage(PackedStorage&& other) noexcept((std::is_nothrow_move_constructible_v<Ts> && ...))
+            {
+                MoveConstruct(other, Indexes());
+            }
+
+            PackedStorage& operator=(const PackedStorage& other)
+            {
+                CopyAssign(other, Indexes());
+                return *this;
+            }
+
+            PackedStorage& operator=(PackedStorage&& other) noexcept((std::is_nothrow_move_assignable_v<Ts> && ...))
+            {
+                MoveAssign(other, Indexes());
+                return *this;
+            }
+
+            ~PackedStorage()
+            {
+                Destroy(Indexes());
+            }
+
+        protected:
+            template <typename... ArgsT>
+            explicit PackedStorage(std::in_place_t, ArgsT&&... args)
+                : Base(std::in_place, std::forward<ArgsT>(args)...)
+            {
+            }
+
+        private:
+            template <std::size_t... I>
+            void CopyConstruct(const PackedStorage& other, std::index_sequence<I...> indexes)
+            {
+                this->Construct(indexes, other.template Get<I>()...);
+            }
+
+            template <std::size_t... I>
+            void MoveConstruct(PackedStorage& other, std::index_sequence<I...> indexes)
+            {
+                this->Construct(indexes, std::move(other.template Get<I>())...);
+            }
+
+            template <std::size_t... I>
+            void CopyAssign(const PackedStorage& other, std::index_sequence<I...>)
+            {
+                ((this->template Get<I>() = other.template Get<I>()), ...);
+            }
+
+            template <std::size_t... I>
+            void MoveAssign(PackedStorage& other, std::index_sequence<I...>)
+            {
+                ((this->template Get<I>() = std::move(other.template Get<I>())), ...);
+            }
+
+            template <std::size_t... I>
+            void Destroy(std::index_sequence<I...>) noexcept
+            {
+                (this->template Get<I>().~Ts(), ...);
+            }
+        };
+
+        template <typename TupleT>
+        struct DeferredCallStorage;
+
+        template <typename... ArgsT>
+        struct DeferredCallStorage<std::tuple<ArgsT...>>
+        {
+            using Type = PackedStorage<(std::is_trivially_copyable_v<std::decay_t<ArgsT>> && ...),
+                                       std::decay_t<ArgsT>...>;
+        };
+
+        template <typename F>
+        using DeferredCallStorage_t = typename DeferredCallStorage<ArgTypes_t<F>>::Type;
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // DeferredCall. Captures (decayed) args for a later call to a function of
+    // type "F" in a padding-free layout. See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class DeferredCall : public Private::DeferredCallStorage_t<F>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(!IsVariadic_v<F>, "Calls to variadic functions can't be deferred");
+
+        using Base = Private::DeferredCallStorage_t<F>;
+        using Indexes = std::make_index_sequence<ArgCount_v<F>>;
+
+    public:
+        using Base::Size_v;
+        using Base::Alignment_v;
+
+        template <std::size_t I>
+        static constexpr std::size_t Offset_v = Base::Offsets[I];
+
+        //////////////////////////////////////////////////////
+        // Captures "args" (one for each of the function's
+        // args, each converted to the decayed arg type)
+        //////////////////////////////////////////////////////
+        template <typename... ArgsT,
+                  std::enable_if_t<sizeof...(ArgsT) == ArgCount_v<F> &&
+                                   !(sizeof...(ArgsT) == 1 && (std::is_same_v<RemoveCvRef_t<ArgsT>, DeferredCall> || ...)),
+                                   int> = 0>
+        explicit DeferredCall(ArgsT&&... args)
+            : Base(std::in_place, std::forward<ArgsT>(args)...)
+        {
+        }
+
+        ///////////////////////////////////////////////////////
+        // Invokes "function" with "leadingArgs" (if any, such
+        // as the object for non-static member functions)
+        // followed by the captured args, as lvalues
+        ///////////////////////////////////////////////////////
+        template <typename FunctionT, typename... LeadingArgsT>
+        ReturnType_t<F> Invoke(FunctionT&& function, LeadingArgsT&&... leadingArgs) &
+        {
+            return InvokeImpl(Indexes(), std::forward<FunctionT>(function), std::forward<LeadingArgsT>(leadingArgs)...);
+        }
+
+        ///////////////////////////////////////////////////////
+        // Same as above but moves the captured args
+        ///////////////////////////////////////////////////////
+        template <typename FunctionT, typename... LeadingArgsT>
+        ReturnType_t<F> Invoke(FunctionT&& function, LeadingArgsT&&... leadingArgs) &&
+        {
+            return InvokeMovedImpl(Indexes(), std::forward<FunctionT>(function), std::forward<LeadingArgsT>(leadingArgs)...);
+        }
+
+    private:
+        template <std::size_t... I, typename FunctionT, typename... LeadingArgsT>
+        ReturnType_t<F> InvokeImpl(std::index_sequence<I...>, FunctionT&& function, LeadingArgsT&&... leadingArgs)
+        {
+            return std::invoke(std::forward<FunctionT>(function),
+                               std::forward<LeadingArgsT>(leadingArgs)...,
+                               this->template Get<I>()...);
+        }
+
+        template <std::size_t... I, typename FunctionT, typename... LeadingArgsT>
+        ReturnType_t<F> InvokeMovedImpl(std::index_sequence<I...>, FunctionT&& function, LeadingArgsT&&... leadingArgs)
+        {
+            return std::invoke(std::forward<FunctionT>(function),
+                               std::forward<LeadingArgsT>(leadingArgs)...,
+                               std::move(this->template Get<I>())...);
+        }
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef DEFERRED_CALL (#include guard)
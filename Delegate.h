@@ -0,0 +1,429 @@
+#ifndef DELEGATE
+#define DELEGATE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Delegate", a non-owning callable
+// consisting of exactly two pointers: an object pointer and a pointer to a
+// "thunk" (a small function generated at compile time for the specific
+// target being bound). The typical use is binding a member function to an
+// object, e.g.:
+//
+//     class Widget
+//     {
+//     public:
+//         void OnClick(int x, int y) const;
+//     };
+//
+//     Widget widget;
+//     auto onClick = MakeDelegate<&Widget::OnClick>(&widget); // "Delegate<void (int, int)>"
+//     onClick(10, 20); // Calls "widget.OnClick(10, 20)"
+//
+// Since the member function pointer is a template arg, the generated thunk
+// calls the member function directly (the compiler sees the exact target,
+// so the call can even be inlined into the thunk), and "Delegate" itself is
+// trivially copyable, never allocates and is invoked with a single indirect
+// call (through the thunk pointer). This compares favorably to the usual
+// approach of wrapping a member function call in a lambda stored in a
+// "std::function" (which may allocate and always pays for the type erasure
+// machinery in "std::function").
+//
+// "FunctionTraits" (see "FunctionTraits.h") is used to work out the
+// object's required qualification from the member function itself, i.e.,
+// the class from "MemberFunctionClass_t", made "const" and/or "volatile"
+// if the member function is (per "IsFunctionConst_v" and
+// "IsFunctionVolatile_v"), and invoked as an rvalue if the member function
+// has the "&&" ref-qualifier (per "FunctionReference_v"). Free functions
+// (including static member functions) and functors (bound by pointer) are
+// also supported.
+//
+// Note that a "Delegate" doesn't own the object it's bound to (it's just a
+// pointer to it), so the object must outlive the "Delegate" (or at least
+// all calls through it).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // SignatureOf_t. Plain function type "R (ArgsT...)
+        // noexcept(IsNoexcept)" built from the return type, arg
+        // types and "noexcept" specification of "F" (any function
+        // type supported by "FunctionTraits"), i.e., "F" stripped
+        // of its class (if any), cv and ref qualifiers and calling
+        // convention. Used whenever we need a single canonical
+        // signature for all functions with the same call interface
+        // (e.g., so that member functions of different classes with
+        // the same parameters yield the same "Delegate" type).
+        ////////////////////////////////////////////////////////////
+        template <typename R,
+                  typename ArgTypesTupleT,
+                  bool IsNoexcept>
+        struct SignatureOfImpl;
+
+        template <typename R,
+                  typename... ArgsT,
+                  bool IsNoexcept>
+        struct SignatureOfImpl<R, std::tuple<ArgsT...>, IsNoexcept>
+        {
+            using Type = R (ArgsT...) noexcept(IsNoexcept);
+        };
+
+        template <TRAITS_FUNCTION_C F>
+        using SignatureOf_t = typename SignatureOfImpl<ReturnType_t<F>, ArgTypes_t<F>, IsNoexcept_v<F>>::Type;
+
+        ////////////////////////////////////////////////////////////
+        // DelegateObject. "Type" is the (possibly cv-qualified)
+        // class that "MemberFunctionT" (a non-static member
+        // function pointer) must be invoked on. Not declared for
+        // any other type (so SFINAE friendly).
+        ////////////////////////////////////////////////////////////
+        template <typename MemberFunctionT,
+                  typename = void>
+        struct DelegateObject
+        {
+        };
+
+        template <typename MemberFunctionT>
+        struct DelegateObject<MemberFunctionT,
+                              std::enable_if_t<std::is_member_function_pointer_v<MemberFunctionT>>>
+        {
+        private:
+            using ClassT = MemberFunctionClass_t<MemberFunctionT>;
+            using ConstClassT = std::conditional_t<IsFunctionConst_v<MemberFunctionT>, const ClassT, ClassT>;
+
+        public:
+            using Type = std::conditional_t<IsFunctionVolatile_v<MemberFunctionT>, volatile ConstClassT, ConstClassT>;
+        };
+
+        template <typename MemberFunctionT>
+        using DelegateObject_t = typename DelegateObject<MemberFunctionT>::Type;
+
+        ////////////////////////////////////////////////////////////
+        // IsInvocableWithArgs. "std::true_type" if "TargetF" is
+        // invocable with "InvokedAsT..." (the object for member
+        // functions, otherwise empty) followed by the types in
+        // "ArgTypesTupleT", and the result is convertible to "R"
+        // (and all of this is "noexcept" if "IsNoexcept" is true).
+        // "std::false_type" otherwise.
+        ////////////////////////////////////////////////////////////
+        template <bool IsNoexcept,
+                  typename R,
+                  typename ArgTypesTupleT,
+                  typename TargetF,
+                  typename... InvokedAsT>
+        struct IsInvocableWithArgs;
+
+        template <bool IsNoexcept,
+                  typename R,
+                  typename... ArgsT,
+                  typename TargetF,
+                  typename... InvokedAsT>
+        struct IsInvocableWithArgs<IsNoexcept, R, std::tuple<ArgsT...>, TargetF, InvokedAsT...>
+            : std::bool_constant<IsNoexcept ? std::is_nothrow_invocable_r_v<R, TargetF, InvokedAsT..., ArgsT...>
+                                            : std::is_invocable_r_v<R, TargetF, InvokedAsT..., ArgsT...>>
+        {
+        };
+
+        ///////////////////////////////////////////////////////////////
+        // DelegateBase. Implementation of "Delegate" (declared after
+        // this namespace), specialized on the arg types of its
+        // signature so that "operator()" takes them by their exact
+        // (declared) types.
+        ///////////////////////////////////////////////////////////////
+        template <typename R,
+                  typename ArgTypesTupleT,
+                  bool IsNoexcept>
+        class DelegateBase;
+
+        template <typename R,
+                  typename... ArgsT,
+                  bool IsNoexcept>
+        class DelegateBase<R, std::tuple<ArgsT...>, IsNoexcept>
+        {
+        public:
+            using ReturnType_t = R;
+            static constexpr bool IsNoexcept_v = IsNoexcept;
+
+            ///////////////////////////////////////////////////////
+            // Type of our thunk. Always receives our object
+            // pointer (ignored when a free function is bound)
+            // followed by the args of the signature.
+            ///////////////////////////////////////////////////////
+            using Thunk_t = R (*)(void *, ArgsT...) noexcept(IsNoexcept);
+
+            constexpr DelegateBase() noexcept = default;
+
+            constexpr DelegateBase(void *object, Thunk_t thunk) noexcept
+                : m_Object(object),
+                  m_Thunk(thunk)
+            {
+            }
+
+            R operator()(ArgsT... args) const noexcept(IsNoexcept)
+            {
+                return m_Thunk(m_Object, std::forward<ArgsT>(args)...);
+            }
+
+            constexpr explicit operator bool() const noexcept
+            {
+                return m_Thunk != nullptr;
+            }
+
+            constexpr void *GetObject() const noexcept
+            {
+                return m_Object;
+            }
+
+            constexpr Thunk_t GetThunk() const noexcept
+            {
+                return m_Thunk;
+            }
+
+            ///////////////////////////////////////////////////////////
+            // Two delegates are equal if they're bound to the same
+            // target on the same object. Note that some linkers may
+            // merge identical thunks (e.g., MSVC's /OPT:ICF option),
+            // so two delegates bound to different functions with
+            // identical machine code may compare equal in that case
+            // (normally harmless since calling either does the same
+            // thing).
+            ///////////////////////////////////////////////////////////
+            friend constexpr bool operator==(const DelegateBase& delegate1, const DelegateBase& delegate2) noexcept
+            {
+                return delegate1.m_Object == delegate2.m_Object &&
+                       delegate1.m_Thunk == delegate2.m_Thunk;
+            }
+
+            friend constexpr bool operator!=(const DelegateBase& delegate1, const DelegateBase& delegate2) noexcept
+            {
+                return !(delegate1 == delegate2);
+            }
+
+        protected:
+            template <auto FunctionT>
+            static R FreeFunctionThunk(void *, ArgsT... args) noexcept(IsNoexcept)
+            {
+                return static_cast<R>(FunctionT(std::forward<ArgsT>(args)...));
+            }
+
+            template <auto MemberFunctionT>
+            static R MemberFunctionThunk(void *object, ArgsT... args) noexcept(IsNoexcept)
+            {
+                using ObjectT = DelegateObject_t<decltype(MemberFunctionT)>;
+                ObjectT *const objectPtr = static_cast<ObjectT *>(object);
+
+                //////////////////////////////////////////////////////
+                // Direct call. "MemberFunctionT" is a compile-time
+                // constant so no member function pointer call
+                // actually takes place (the compiler calls the
+                // target directly, or devirtualizes through the
+                // object's vtable if the member is virtual)
+                //////////////////////////////////////////////////////
+                if constexpr (FunctionReference_v<decltype(MemberFunctionT)> == FunctionReference::RValue)
+                {
+                    return static_cast<R>((std::move(*objectPtr).*MemberFunctionT)(std::forward<ArgsT>(args)...));
+                }
+                else
+                {
+                    return static_cast<R>((objectPtr->*MemberFunctionT)(std::forward<ArgsT>(args)...));
+                }
+            }
+
+            template <typename FunctorT>
+            static R FunctorThunk(void *object, ArgsT... args) noexcept(IsNoexcept)
+            {
+                return static_cast<R>((*static_cast<FunctorT *>(object))(std::forward<ArgsT>(args)...));
+            }
+
+            template <typename T>
+            static constexpr void *ToObject(T *object) noexcept
+            {
+                return const_cast<void *>(static_cast<const volatile void *>(object));
+            }
+
+        private:
+            void *m_Object = nullptr;
+            Thunk_t m_Thunk = nullptr;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Delegate. Two-pointer, trivially copyable, non-owning callable bound to
+    // a member function and an object (or to a free function, or to a functor
+    // by pointer). See top of this file for details. "F" is the signature of
+    // "operator()" and can be any function type supported by "FunctionTraits"
+    // but only its return type, arg types and "noexcept" specification are
+    // used (normally you'll just pass a plain function type such as
+    // "void (int)", and "MakeDelegate()" further below always produces a
+    // "Delegate" specialized on such a type). Note that "operator()" is always
+    // "const" since a "Delegate" is merely a reference to its target (similar
+    // to a pointer).
+    //
+    // Binding is done through the static "Bind()" members (or more
+    // conveniently "MakeDelegate()" further below):
+    //
+    //     Delegate<void (int)>::Bind<&SomeFreeFunction>();
+    //     Delegate<void (int)>::Bind<&SomeClass::SomeMemberFunction>(&someObject);
+    //     Delegate<void (int)>::Bind(&someFunctor);
+    //
+    // In all cases the target is checked at compile time to ensure it's
+    // callable with the delegate's signature (and if the signature is
+    // "noexcept", that the target is also "noexcept").
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class Delegate : public Private::DelegateBase<ReturnType_t<F>, ArgTypes_t<F>, IsNoexcept_v<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(!IsVariadic_v<F>, "Variadic functions aren't supported by \"Delegate\"");
+
+        using BaseClass = Private::DelegateBase<ReturnType_t<F>, ArgTypes_t<F>, IsNoexcept_v<F>>;
+
+        /////////////////////////////////////////////////////////
+        // True if "TargetF" (the type of the target being
+        // bound) can be bound to this "Delegate", i.e., it's
+        // invocable (in the context "InvokedAsT") with our
+        // arg types, its result is convertible to our return
+        // type, and it's "noexcept" if we are
+        /////////////////////////////////////////////////////////
+        template <typename TargetF,
+                  typename... InvokedAsT>
+        static constexpr bool IsBindable_v = Private::IsInvocableWithArgs<BaseClass::IsNoexcept_v,
+                                                                           ReturnType_t<F>,
+                                                                           ArgTypes_t<F>,
+                                                                           TargetF,
+                                                                           InvokedAsT...>::value;
+
+    public:
+        using BaseClass::BaseClass;
+
+        ////////////////////////////////////////////////////////////
+        // Binds a free function (including a static member
+        // function). The object pointer is unused (null).
+        ////////////////////////////////////////////////////////////
+        template <auto FunctionT,
+                  std::enable_if_t<IsTraitsFreeFunction_v<std::remove_pointer_t<decltype(FunctionT)>>, int> = 0>
+        static constexpr Delegate Bind() noexcept
+        {
+            static_assert(IsBindable_v<decltype(FunctionT)>,
+                          "Free function can't be bound to this \"Delegate\" (it's not invocable with the "
+                          "delegate's arg types, or its return type isn't convertible to the delegate's, "
+                          "or the delegate is \"noexcept\" but the function isn't)");
+
+            return Delegate(nullptr, &BaseClass::template FreeFunctionThunk<FunctionT>);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Binds a non-static member function to "object". The
+        // type of "object" is determined by the member function
+        // itself (see "Private::DelegateObject"), e.g., "const"
+        // member functions accept a pointer to a "const" object
+        // (but non-const member functions don't).
+        ////////////////////////////////////////////////////////////
+        template <auto MemberFunctionT>
+        static constexpr Delegate Bind(Private::DelegateObject_t<decltype(MemberFunctionT)> *object) noexcept
+        {
+            using ObjectT = Private::DelegateObject_t<decltype(MemberFunctionT)>;
+            using InvokedAsT = std::conditional_t<FunctionReference_v<decltype(MemberFunctionT)> == FunctionReference::RValue,
+                                                  ObjectT &&,
+                                                  ObjectT &>;
+            static_assert(IsBindable_v<decltype(MemberFunctionT), InvokedAsT>,
+                          "Member function can't be bound to this \"Delegate\" (it's not invocable with the "
+                          "delegate's arg types, or its return type isn't convertible to the delegate's, "
+                          "or the delegate is \"noexcept\" but the member function isn't)");
+
+            return Delegate(BaseClass::ToObject(object), &BaseClass::template MemberFunctionThunk<MemberFunctionT>);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Binds a functor (including a lambda) by pointer. The
+        // functor isn't copied so it must outlive the delegate.
+        ////////////////////////////////////////////////////////////
+        template <typename FunctorT,
+                  std::enable_if_t<std::is_class_v<FunctorT>, int> = 0>
+        static constexpr Delegate Bind(FunctorT *functor) noexcept
+        {
+            static_assert(IsBindable_v<FunctorT &>,
+                          "Functor can't be bound to this \"Delegate\" (it's not invocable with the "
+                          "delegate's arg types, or its return type isn't convertible to the delegate's, "
+                          "or the delegate is \"noexcept\" but the functor isn't)");
+
+            return Delegate(BaseClass::ToObject(functor), &BaseClass::template FunctorThunk<FunctorT>);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeDelegate(). Binds a member function to an object, returning a
+    // "Delegate" specialized on the member function's plain signature
+    // (return type, arg types and "noexcept" specification only - the
+    // class, cv and ref qualifiers and calling convention are dropped), so
+    // member functions of different classes with the same parameters yield
+    // the same "Delegate" type (and can therefore be stored in the same
+    // container).
+    ///////////////////////////////////////////////////////////////////////////
+    template <auto MemberFunctionT>
+    constexpr auto MakeDelegate(Private::DelegateObject_t<decltype(MemberFunctionT)> *object) noexcept
+    {
+        return Delegate<Private::SignatureOf_t<decltype(MemberFunctionT)>>::template Bind<MemberFunctionT>(object);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeDelegate(). Same as above but binds a free function (including a
+    // static member function)
+    ///////////////////////////////////////////////////////////////////////////
+    template <auto FunctionT,
+              std::enable_if_t<IsTraitsFreeFunction_v<std::remove_pointer_t<decltype(FunctionT)>>, int> = 0>
+    constexpr auto MakeDelegate() noexcept
+    {
+        return Delegate<Private::SignatureOf_t<decltype(FunctionT)>>::template Bind<FunctionT>();
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef DELEGATE (#include guard)
@@ -0,0 +1,281 @@
+#ifndef EVENT_DISPATCHER
+#define EVENT_DISPATCHER
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "EventDispatcher", which routes
+// events to handlers by event type through a constant (compile-time)
+// table, replacing the usual chain of "dynamic_cast"s (or a runtime map
+// of type to handler), e.g.:
+//
+//     void OnKey(const KeyEvent& event);
+//     void OnMouse(const MouseEvent& event);
+//     void OnResize(ResizeEvent event) noexcept;
+//
+//     using Dispatcher = EventDispatcher<&OnKey, &OnMouse, &OnResize>;
+//
+//     // Event type known at compile time (no lookup at all)
+//     Dispatcher::Dispatch(KeyEvent{...});
+//
+//     // Event type known only at runtime, e.g., an event queue holding
+//     // each event's "EventId_v" (the hash of its type) and its address
+//     if (!Dispatcher::Dispatch(event.m_Id, event.m_Data))
+//     {
+//         // No handler for this event type
+//     }
+//
+// Each handler is a free function (or static member function) taking a
+// single arg, the event (by value or by "const" reference), whose type is
+// determined at compile time from the handler itself via "ArgType_t" (see
+// "FunctionTraits.h"). The event's type ID is "EventId_v<EventT>", which
+// is just "TypeNameHash_v<EventT>" (a compile-time hash of the event
+// type's name). A minimal perfect hash over the IDs of all event types
+// handled is built at compile time (see "Private::MakePerfectHash()" in
+// "StaticDispatchTable.h"), so dispatching an event by ID costs one table
+// probe, one comparison of the stored ID (to reject unhandled event
+// types) and one indirect call, regardless of the number of handlers.
+//
+// Two handlers for the same event type (including, say, one taking it by
+// value and the other by "const" reference), or two event types whose IDs
+// collide (extremely unlikely), are rejected at compile time. Note that
+// since "TypeName_v" is compiler-specific, event IDs shouldn't be
+// persisted or exchanged with binaries built by another compiler.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "StaticDispatchTable.h" #includes "FunctionTraits.h", which
+// #includes "CompilerVersions.h" so all C++ version constants
+// such as CPP17_OR_LATER (tested just below) are available
+// after the following
+////////////////////////////////////////////////////////////////
+#include "StaticDispatchTable.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <type_traits>
+#endif
+
+namespace StdExt
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // EventId_v. Type ID of event type "EventT" as used by "EventDispatcher"
+    // (cv-qualifiers ignored)
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename EventT>
+    inline constexpr std::uint64_t EventId_v = TypeNameHash_v<std::remove_cv_t<EventT>>;
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Type of event handled by "HandlerV" (the decayed type of
+        // its only arg)
+        ////////////////////////////////////////////////////////////
+        template <auto HandlerV>
+        using EventHandlerEvent_t = RemoveCvRef_t<ArgType_t<std::remove_const_t<decltype(HandlerV)>, 0>>;
+
+        template <auto HandlerV>
+        void EventHandlerThunk(const void* event)
+        {
+            HandlerV(*static_cast<const EventHandlerEvent_t<HandlerV>*>(event));
+        }
+
+        template <auto HandlerV>
+        constexpr bool IsValidEventHandler() noexcept
+        {
+            using F = std::remove_const_t<decltype(HandlerV)>;
+
+            static_assert(IsTraitsFreeFunction_v<F>,
+                          "Event handlers must be (pointers to) free functions or static member functions");
+            static_assert(ArgCount_v<F> == 1 && !IsVariadic_v<F>,
+                          "Event handlers must take exactly one arg (the event)");
+
+            using ArgT = ArgType_t<F, 0>;
+            static_assert(std::is_object_v<RemoveCvRef_t<ArgT>> &&
+                          !std::is_volatile_v<std::remove_reference_t<ArgT>> &&
+                          (!std::is_reference_v<ArgT> ||
+                           (std::is_lvalue_reference_v<ArgT> && std::is_const_v<std::remove_reference_t<ArgT>>)),
+                          "Event handlers must take the event by value or by \"const\" reference");
+            static_assert(std::is_void_v<ReturnType_t<F>>,
+                          "Event handlers must return \"void\"");
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Table entry, the ID of an event type and its handler's
+        // thunk
+        ////////////////////////////////////////////////////////////
+        struct EventDispatchEntry
+        {
+            std::uint64_t m_EventId = 0;
+            void (*m_Thunk)(const void* event) = nullptr;
+        };
+
+        template <typename EventT,
+                  typename... EventsT>
+        inline constexpr std::size_t EventTypeCount_v = (std::size_t{std::is_same_v<EventT, EventsT>} + ... + 0);
+
+        ////////////////////////////////////////////////////////////
+        // True if no event type in "EventsT" occurs more than once
+        ////////////////////////////////////////////////////////////
+        template <typename... EventsT>
+        inline constexpr bool IsUniqueEventTypes_v = ((EventTypeCount_v<EventsT, EventsT...> == 1) && ...);
+
+        template <std::size_t N>
+        constexpr bool HasDuplicateEventIds(const std::array<std::uint64_t, N>& eventIds) noexcept
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                for (std::size_t j = i + 1; j < N; ++j)
+                {
+                    if (eventIds[i] == eventIds[j])
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Entries of the table for "HandlersV" (each stored in the
+        // slot the perfect hash assigns its event ID)
+        ////////////////////////////////////////////////////////////
+        template <auto... HandlersV>
+        constexpr std::array<EventDispatchEntry, sizeof...(HandlersV)> MakeEventDispatchEntries(const PerfectHash<sizeof...(HandlersV)>& perfectHash) noexcept
+        {
+            constexpr std::array<EventDispatchEntry, sizeof...(HandlersV)> entries = {EventDispatchEntry{EventId_v<EventHandlerEvent_t<HandlersV>>,
+                                                                                                        &EventHandlerThunk<HandlersV>}...};
+
+            std::array<EventDispatchEntry, sizeof...(HandlersV)> table{};
+            for (std::size_t i = 0; i < sizeof...(HandlersV); ++i)
+            {
+                table[perfectHash.m_Slots[i]] = entries[i];
+            }
+
+            return table;
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // EventDispatcher. Routes events to "HandlersV" (one per event type) by
+    // event type, through a compile-time perfect hash table keyed on
+    // "EventId_v". Stateless (all members are static). See top of this file
+    // for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <auto... HandlersV>
+    class EventDispatcher
+    {
+        static_assert(sizeof...(HandlersV) != 0, "\"EventDispatcher\" requires at least one handler");
+        static_assert((Private::IsValidEventHandler<HandlersV>() && ...));
+        static_assert(Private::IsUniqueEventTypes_v<Private::EventHandlerEvent_t<HandlersV>...>,
+                      "More than one handler was passed for the same event type");
+
+        static constexpr std::array<std::uint64_t, sizeof...(HandlersV)> EventIds_v = {EventId_v<Private::EventHandlerEvent_t<HandlersV>>...};
+
+        static_assert(!Private::IsUniqueEventTypes_v<Private::EventHandlerEvent_t<HandlersV>...> || !Private::HasDuplicateEventIds(EventIds_v),
+                      "The IDs of two distinct event types collide (\"EventId_v\"), so they can't both be handled "
+                      "by the same \"EventDispatcher\"");
+
+        static constexpr Private::PerfectHash<sizeof...(HandlersV)> PerfectHash_v = Private::MakePerfectHash(EventIds_v);
+        static constexpr std::array<Private::EventDispatchEntry, sizeof...(HandlersV)> Entries_v = Private::MakeEventDispatchEntries<HandlersV...>(PerfectHash_v);
+
+    public:
+        static constexpr std::size_t Size_v = sizeof...(HandlersV);
+
+        ///////////////////////////////////////////////////////
+        // True if all handlers are "noexcept" (in which case
+        // "Dispatch()" is as well)
+        ///////////////////////////////////////////////////////
+        static constexpr bool IsNoexcept_v = (StdExt::IsNoexcept_v<std::remove_const_t<decltype(HandlersV)>> && ...);
+
+        ///////////////////////////////////////////////////////
+        // True if one of the handlers handles "EventT"
+        ///////////////////////////////////////////////////////
+        template <typename EventT>
+        static constexpr bool Handles_v = (std::is_same_v<Private::EventHandlerEvent_t<HandlersV>, RemoveCvRef_t<EventT>> || ...);
+
+        ///////////////////////////////////////////////////////
+        // Same as above but for event ID "eventId"
+        ///////////////////////////////////////////////////////
+        static constexpr bool Handles(std::uint64_t eventId) noexcept
+        {
+            return Entries_v[Private::GetPerfectHashSlot(eventId, PerfectHash_v.m_Displacements)].m_EventId == eventId;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Passes "event" to the handler for its type
+        // (resolved at compile time). Returns false if there
+        // is none (in which case nothing is called).
+        ///////////////////////////////////////////////////////
+        template <typename EventT>
+        static bool Dispatch(const EventT& event) noexcept(IsNoexcept_v)
+        {
+            return (DispatchTo<HandlersV>(event) || ...);
+        }
+
+        ///////////////////////////////////////////////////////
+        // Passes the event at address "event", whose ID is
+        // "eventId" (i.e., "EventId_v" of its type), to the
+        // handler for its type. Returns false if there is none
+        // (in which case nothing is called).
+        ///////////////////////////////////////////////////////
+        static bool Dispatch(std::uint64_t eventId, const void* event) noexcept(IsNoexcept_v)
+        {
+            const Private::EventDispatchEntry& entry = Entries_v[Private::GetPerfectHashSlot(eventId, PerfectHash_v.m_Displacements)];
+            if (entry.m_EventId != eventId)
+            {
+                return false;
+            }
+
+            entry.m_Thunk(event);
+            return true;
+        }
+
+    private:
+        template <auto HandlerV,
+                  typename EventT>
+        static bool DispatchTo(const EventT& event) noexcept(IsNoexcept_v)
+        {
+            if constexpr (std::is_same_v<Private::EventHandlerEvent_t<HandlerV>, EventT>)
+            {
+                HandlerV(event);
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        }
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef EVENT_DISPATCHER (#include guard)
@@ -0,0 +1,846 @@
+#ifndef FUNCTION_REGISTRY
+#define FUNCTION_REGISTRY
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class "FunctionRegistry", which records signature
+// descriptors for registered functions (obtained via "FunctionTraits", see
+// "FunctionTraits.h"), and serializes them into a binary "signature
+// catalog" designed to be memory mapped and queried in place (no
+// deserialization), via "SignatureCatalogView" (over any memory) or
+// "MappedSignatureCatalog" (memory maps a catalog file). Each descriptor
+// holds:
+//
+// 1) The name the function was registered under
+// 2) Its signature hash ("SignatureHash_v" below), the key for lookups
+// 3) Its type name, return type name and the name of each arg type (all
+//    via "TypeName_v")
+// 4) The size and alignment of its return type and each arg type (for
+//    reference types, the size and alignment of a pointer, which is how
+//    references are passed)
+// 5) Its "noexcept" specification, variadic status, calling convention
+//    and classification (free or non-static member function)
+//
+// The catalog layout is as follows (all sections 8-byte aligned, all
+// integers in native byte order):
+//
+//     +--------------------------------------------------------------+
+//     | Header (magic "FTSIGCAT", version, section offsets, counts)  |
+//     +--------------------------------------------------------------+
+//     | Hash table (open addressing, linear probing): one uint32 per |
+//     | bucket, zero if empty or (entry index + 1) otherwise         |
+//     +--------------------------------------------------------------+
+//     | Entries (fixed size, one per registered function)            |
+//     +--------------------------------------------------------------+
+//     | Args (fixed size, all entries' args back to back)            |
+//     +--------------------------------------------------------------+
+//     | String pool (names, not null terminated)                     |
+//     +--------------------------------------------------------------+
+//
+// so opening a catalog only validates its header (O(1)) and lookups by
+// signature hash ("SignatureCatalogView::Find()") are O(1) (a hash table
+// probe). Note that type names (and therefore signature hashes) are
+// compiler-specific (see "TypeName_v"), so catalogs should be produced and
+// consumed by binaries built with the same compiler. Catalogs are also
+// assumed to be produced by "FunctionRegistry" (a trusted source). Only
+// the header and section bounds are validated when opened, while
+// individual strings and arg ranges that fall out of bounds are returned
+// as empty.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <deque>
+    #include <fstream>
+    #include <stdexcept>
+    #include <string>
+    #include <string_view>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+#if defined(_WIN32)
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    // POSIX headers
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Size and alignment recorded for a return or arg type
+        // "T" (see top of file)
+        ////////////////////////////////////////////////////////////
+        template <typename T>
+        constexpr std::uint32_t GetSignatureTypeSize() noexcept
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                return 0;
+            }
+            else if constexpr (std::is_reference_v<T>)
+            {
+                return sizeof(void *);
+            }
+            else
+            {
+                return sizeof(T);
+            }
+        }
+
+        template <typename T>
+        constexpr std::uint32_t GetSignatureTypeAlignment() noexcept
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                return 0;
+            }
+            else if constexpr (std::is_reference_v<T>)
+            {
+                return alignof(void *);
+            }
+            else
+            {
+                return alignof(T);
+            }
+        }
+
+        template <TRAITS_FUNCTION_C F>
+        constexpr std::uint64_t GetSignatureHash() noexcept
+        {
+            //////////////////////////////////////////////////////
+            // Hash of the raw function type (so pointers and
+            // references to the same function type yield the
+            // same hash), continued with the class name for
+            // non-static member functions (since the raw type
+            // doesn't include the class)
+            //////////////////////////////////////////////////////
+            constexpr std::uint64_t hash = TypeNameHash_v<FunctionRawType_t<F>>;
+            if constexpr (FunctionClassification_v<F> == FunctionClassification::NonStaticMember)
+            {
+                return Fnv1aHash(TypeName_v<MemberFunctionClass_t<F>>, hash);
+            }
+            else
+            {
+                return hash;
+            }
+        }
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // SignatureHash_v. 64 bit hash identifying the signature of "F" (any
+    // function type supported by "FunctionTraits"), the key for lookups in a
+    // signature catalog. Based on "TypeNameHash_v" so only stable across
+    // binaries built with the same compiler.
+    ///////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    inline constexpr std::uint64_t SignatureHash_v = Private::GetSignatureHash<F>();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // ArgDescriptor and SignatureDescriptor. Descriptor of a registered
+    // function (see top of file). Type names are views of the static strings
+    // returned by "TypeName_v" (so always valid).
+    ///////////////////////////////////////////////////////////////////////////
+    struct ArgDescriptor
+    {
+        tstring_view m_TypeName;
+        std::uint32_t m_Size;
+        std::uint32_t m_Alignment;
+    };
+
+    struct SignatureDescriptor
+    {
+        std::string m_Name;
+        std::uint64_t m_Hash;
+        tstring_view m_TypeName;
+        tstring_view m_ReturnTypeName;
+        std::uint32_t m_ReturnSize;
+        std::uint32_t m_ReturnAlignment;
+        std::vector<ArgDescriptor> m_Args;
+        bool m_IsNoexcept;
+        bool m_IsVariadic;
+        CallingConvention m_CallingConvention;
+        FunctionClassification m_Classification;
+    };
+
+    namespace Private
+    {
+        template <typename F,
+                  std::size_t... I>
+        std::vector<ArgDescriptor> MakeArgDescriptors(std::index_sequence<I...>)
+        {
+            return {ArgDescriptor{TypeName_v<ArgType_t<F, I>>,
+                                  GetSignatureTypeSize<ArgType_t<F, I>>(),
+                                  GetSignatureTypeAlignment<ArgType_t<F, I>>()}...};
+        }
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeSignatureDescriptor(). Returns the "SignatureDescriptor" of "F" (any
+    // function type supported by "FunctionTraits"), registered under "name"
+    ///////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    SignatureDescriptor MakeSignatureDescriptor(std::string_view name)
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        return SignatureDescriptor{std::string(name),
+                                   SignatureHash_v<F>,
+                                   FunctionTypeName_v<F>,
+                                   ReturnTypeName_v<F>,
+                                   Private::GetSignatureTypeSize<ReturnType_t<F>>(),
+                                   Private::GetSignatureTypeAlignment<ReturnType_t<F>>(),
+                                   Private::MakeArgDescriptors<F>(std::make_index_sequence<ArgCount_v<F>>()),
+                                   IsNoexcept_v<F>,
+                                   IsVariadic_v<F>,
+                                   CallingConvention_v<F>,
+                                   FunctionClassification_v<F>};
+    }
+
+    // Current version of the signature catalog format
+    inline constexpr std::uint32_t SignatureCatalogVersion_v = 1;
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // On-disk structures of a signature catalog (see top of
+        // file). String offsets are in bytes (from the start of
+        // the string pool), lengths in characters.
+        ////////////////////////////////////////////////////////////
+        inline constexpr char SignatureCatalogMagic[8] = {'F', 'T', 'S', 'I', 'G', 'C', 'A', 'T'};
+
+        struct SignatureCatalogHeader
+        {
+            char m_Magic[8];
+            std::uint32_t m_Version;
+            std::uint32_t m_CharSize; // "sizeof(tchar)" of the type names
+            std::uint32_t m_EntryCount;
+            std::uint32_t m_BucketCount; // Power of 2
+            std::uint32_t m_ArgCount;
+            std::uint32_t m_Reserved;
+            std::uint64_t m_BucketsOffset;
+            std::uint64_t m_EntriesOffset;
+            std::uint64_t m_ArgsOffset;
+            std::uint64_t m_StringsOffset;
+            std::uint64_t m_StringsSize;
+            std::uint64_t m_FileSize;
+        };
+
+        struct SignatureCatalogString
+        {
+            std::uint32_t m_Offset;
+            std::uint32_t m_Length;
+        };
+
+        struct SignatureCatalogEntry
+        {
+            std::uint64_t m_Hash;
+            SignatureCatalogString m_Name;
+            SignatureCatalogString m_TypeName;
+            SignatureCatalogString m_ReturnTypeName;
+            std::uint32_t m_ReturnSize;
+            std::uint32_t m_ReturnAlignment;
+            std::uint32_t m_FirstArg;
+            std::uint32_t m_ArgCount;
+            std::uint8_t m_IsNoexcept;
+            std::uint8_t m_IsVariadic;
+            std::uint8_t m_CallingConvention;
+            std::uint8_t m_Classification;
+            std::uint32_t m_Reserved;
+        };
+
+        struct SignatureCatalogArg
+        {
+            SignatureCatalogString m_TypeName;
+            std::uint32_t m_Size;
+            std::uint32_t m_Alignment;
+        };
+
+        static_assert(sizeof(SignatureCatalogHeader) == 80 &&
+                      sizeof(SignatureCatalogEntry) == 56 &&
+                      sizeof(SignatureCatalogArg) == 16,
+                      "Unexpected padding in signature catalog structures");
+
+        constexpr std::uint64_t AlignCatalogOffset(std::uint64_t offset) noexcept
+        {
+            return (offset + 7) & ~std::uint64_t{7};
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Appends strings to a catalog's string pool
+        ////////////////////////////////////////////////////////////
+        class SignatureCatalogStringPool
+        {
+        public:
+            template <typename CharT>
+            SignatureCatalogString Add(std::basic_string_view<CharT> str)
+            {
+                // Align for the character type
+                m_Bytes.resize((m_Bytes.size() + sizeof(CharT) - 1) / sizeof(CharT) * sizeof(CharT));
+
+                const SignatureCatalogString catalogString = {static_cast<std::uint32_t>(m_Bytes.size()),
+                                                              static_cast<std::uint32_t>(str.size())};
+
+                const std::size_t byteCount = str.size() * sizeof(CharT);
+                m_Bytes.resize(m_Bytes.size() + byteCount);
+                if (byteCount != 0)
+                {
+                    std::memcpy(m_Bytes.data() + catalogString.m_Offset, str.data(), byteCount);
+                }
+
+                return catalogString;
+            }
+
+            const std::vector<std::byte>& GetBytes() const noexcept
+            {
+                return m_Bytes;
+            }
+
+        private:
+            std::vector<std::byte> m_Bytes;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // FunctionRegistry. Records "SignatureDescriptor"s for registered
+    // functions and serializes them into a signature catalog (see top of
+    // file). Not thread safe (register functions from a single thread or
+    // synchronize externally).
+    /////////////////////////////////////////////////////////////////////////////
+    class FunctionRegistry
+    {
+    public:
+        ////////////////////////////////////////////////////////
+        // Registers function type "F" under "name", returning
+        // its descriptor (references remain valid for the
+        // life of the registry)
+        ////////////////////////////////////////////////////////
+        template <TRAITS_FUNCTION_C F>
+        const SignatureDescriptor& Register(std::string_view name)
+        {
+            return m_Descriptors.emplace_back(MakeSignatureDescriptor<F>(name));
+        }
+
+        ////////////////////////////////////////////////////////
+        // Same as above but registers function "FunctionT"
+        // (e.g., "Register<&SomeFunction>("SomeFunction")")
+        ////////////////////////////////////////////////////////
+        template <auto FunctionT>
+        const SignatureDescriptor& Register(std::string_view name)
+        {
+            return Register<decltype(FunctionT)>(name);
+        }
+
+        const std::deque<SignatureDescriptor>& GetDescriptors() const noexcept
+        {
+            return m_Descriptors;
+        }
+
+        ////////////////////////////////////////////////////////
+        // Returns the signature catalog for all registered
+        // functions (see top of file for its layout)
+        ////////////////////////////////////////////////////////
+        std::vector<std::byte> Serialize() const
+        {
+            using namespace Private;
+
+            const std::size_t entryCount = m_Descriptors.size();
+
+            // Hash table at most half full (and at least 1 bucket)
+            std::size_t bucketCount = 1;
+            while (bucketCount < entryCount * 2)
+            {
+                bucketCount *= 2;
+            }
+
+            std::vector<std::uint32_t> buckets(bucketCount, 0);
+            std::vector<SignatureCatalogEntry> entries;
+            std::vector<SignatureCatalogArg> args;
+            SignatureCatalogStringPool strings;
+
+            entries.reserve(entryCount);
+            for (const SignatureDescriptor& descriptor : m_Descriptors)
+            {
+                SignatureCatalogEntry entry{};
+                entry.m_Hash = descriptor.m_Hash;
+                entry.m_Name = strings.Add(std::string_view(descriptor.m_Name));
+                entry.m_TypeName = strings.Add(descriptor.m_TypeName);
+                entry.m_ReturnTypeName = strings.Add(descriptor.m_ReturnTypeName);
+                entry.m_ReturnSize = descriptor.m_ReturnSize;
+                entry.m_ReturnAlignment = descriptor.m_ReturnAlignment;
+                entry.m_FirstArg = static_cast<std::uint32_t>(args.size());
+                entry.m_ArgCount = static_cast<std::uint32_t>(descriptor.m_Args.size());
+                entry.m_IsNoexcept = descriptor.m_IsNoexcept;
+                entry.m_IsVariadic = descriptor.m_IsVariadic;
+                entry.m_CallingConvention = static_cast<std::uint8_t>(descriptor.m_CallingConvention);
+                entry.m_Classification = static_cast<std::uint8_t>(descriptor.m_Classification);
+
+                for (const ArgDescriptor& arg : descriptor.m_Args)
+                {
+                    args.push_back(SignatureCatalogArg{strings.Add(arg.m_TypeName), arg.m_Size, arg.m_Alignment});
+                }
+
+                ///////////////////////////////////////////////////
+                // Insert into the hash table (linear probing).
+                // Entries with the same hash are all inserted
+                // (found in registration order).
+                ///////////////////////////////////////////////////
+                std::size_t bucket = static_cast<std::size_t>(entry.m_Hash) & (bucketCount - 1);
+                while (buckets[bucket] != 0)
+                {
+                    bucket = (bucket + 1) & (bucketCount - 1);
+                }
+                buckets[bucket] = static_cast<std::uint32_t>(entries.size() + 1);
+
+                entries.push_back(entry);
+            }
+
+            SignatureCatalogHeader header{};
+            std::memcpy(header.m_Magic, SignatureCatalogMagic, sizeof(header.m_Magic));
+            header.m_Version = SignatureCatalogVersion_v;
+            header.m_CharSize = sizeof(tchar);
+            header.m_EntryCount = static_cast<std::uint32_t>(entryCount);
+            header.m_BucketCount = static_cast<std::uint32_t>(bucketCount);
+            header.m_ArgCount = static_cast<std::uint32_t>(args.size());
+            header.m_BucketsOffset = AlignCatalogOffset(sizeof(header));
+            header.m_EntriesOffset = AlignCatalogOffset(header.m_BucketsOffset + buckets.size() * sizeof(std::uint32_t));
+            header.m_ArgsOffset = AlignCatalogOffset(header.m_EntriesOffset + entries.size() * sizeof(SignatureCatalogEntry));
+            header.m_StringsOffset = AlignCatalogOffset(header.m_ArgsOffset + args.size() * sizeof(SignatureCatalogArg));
+            header.m_StringsSize = strings.GetBytes().size();
+            header.m_FileSize = header.m_StringsOffset + header.m_StringsSize;
+
+            std::vector<std::byte> catalog(static_cast<std::size_t>(header.m_FileSize));
+            const auto write = [&catalog](std::uint64_t offset, const void *data, std::size_t size)
+                               {
+                                   if (size != 0)
+                                   {
+                                       std::memcpy(catalog.data() + offset, data, size);
+                                   }
+                               };
+
+            write(0, &header, sizeof(header));
+            write(header.m_BucketsOffset, buckets.data(), buckets.size() * sizeof(std::uint32_t));
+            write(header.m_EntriesOffset, entries.data(), entries.size() * sizeof(SignatureCatalogEntry));
+            write(header.m_ArgsOffset, args.data(), args.size() * sizeof(SignatureCatalogArg));
+            write(header.m_StringsOffset, strings.GetBytes().data(), strings.GetBytes().size());
+
+            return catalog;
+        }
+
+        ////////////////////////////////////////////////////////
+        // Writes the signature catalog to file "path"
+        // (throws "std::runtime_error" on failure)
+        ////////////////////////////////////////////////////////
+        void Save(const std::string& path) const
+        {
+            const std::vector<std::byte> catalog = Serialize();
+
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(catalog.data()), static_cast<std::streamsize>(catalog.size()));
+            if (!file)
+            {
+                throw std::runtime_error("Unable to write signature catalog: " + path);
+            }
+        }
+
+    private:
+        std::deque<SignatureDescriptor> m_Descriptors;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // SignatureCatalogView. Read-only view of a signature catalog in memory
+    // (typically memory mapped, see "MappedSignatureCatalog" below). Opening
+    // a view validates the header only (O(1)) and nothing is copied. The
+    // memory must remain valid (and unchanged) for the life of the view and
+    // must be 8-byte aligned.
+    /////////////////////////////////////////////////////////////////////////////
+    class SignatureCatalogView
+    {
+    public:
+        ////////////////////////////////////////////////////////
+        // Arg of an entry (see "Entry::GetArg()")
+        ////////////////////////////////////////////////////////
+        struct Arg
+        {
+            tstring_view m_TypeName;
+            std::uint32_t m_Size;
+            std::uint32_t m_Alignment;
+        };
+
+        ////////////////////////////////////////////////////////
+        // Lightweight handle to an entry in the catalog (the
+        // descriptor of one registered function)
+        ////////////////////////////////////////////////////////
+        class Entry
+        {
+        public:
+            std::uint64_t GetHash() const noexcept
+            {
+                return m_Entry->m_Hash;
+            }
+
+            std::string_view GetName() const noexcept
+            {
+                return m_Catalog->GetString<char>(m_Entry->m_Name);
+            }
+
+            tstring_view GetTypeName() const noexcept
+            {
+                return m_Catalog->GetString<tchar>(m_Entry->m_TypeName);
+            }
+
+            tstring_view GetReturnTypeName() const noexcept
+            {
+                return m_Catalog->GetString<tchar>(m_Entry->m_ReturnTypeName);
+            }
+
+            std::uint32_t GetReturnSize() const noexcept
+            {
+                return m_Entry->m_ReturnSize;
+            }
+
+            std::uint32_t GetReturnAlignment() const noexcept
+            {
+                return m_Entry->m_ReturnAlignment;
+            }
+
+            std::size_t GetArgCount() const noexcept
+            {
+                return m_Catalog->IsArgRangeValid(m_Entry->m_FirstArg, m_Entry->m_ArgCount) ? m_Entry->m_ArgCount : 0;
+            }
+
+            // "index" must be less than "GetArgCount()"
+            Arg GetArg(std::size_t index) const noexcept
+            {
+                const Private::SignatureCatalogArg& arg = m_Catalog->m_Args[m_Entry->m_FirstArg + index];
+                return Arg{m_Catalog->GetString<tchar>(arg.m_TypeName), arg.m_Size, arg.m_Alignment};
+            }
+
+            bool IsNoexcept() const noexcept
+            {
+                return m_Entry->m_IsNoexcept != 0;
+            }
+
+            bool IsVariadic() const noexcept
+            {
+                return m_Entry->m_IsVariadic != 0;
+            }
+
+            CallingConvention GetCallingConvention() const noexcept
+            {
+                return static_cast<CallingConvention>(m_Entry->m_CallingConvention);
+            }
+
+            FunctionClassification GetClassification() const noexcept
+            {
+                return static_cast<FunctionClassification>(m_Entry->m_Classification);
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return m_Entry != nullptr;
+            }
+
+        private:
+            friend class SignatureCatalogView;
+
+            Entry(const SignatureCatalogView *catalog, const Private::SignatureCatalogEntry *entry) noexcept
+                : m_Catalog(catalog),
+                  m_Entry(entry)
+            {
+            }
+
+            const SignatureCatalogView *m_Catalog;
+            const Private::SignatureCatalogEntry *m_Entry;
+        };
+
+        ////////////////////////////////////////////////////////
+        // Opens the catalog in "data" ("size" bytes), throwing
+        // "std::runtime_error" if it's not a valid catalog
+        // (bad magic number, unsupported version, different
+        // character size, misaligned, or any section out of
+        // bounds)
+        ////////////////////////////////////////////////////////
+        SignatureCatalogView(const void *data, std::size_t size)
+            : m_Data(static_cast<const std::byte *>(data))
+        {
+            using namespace Private;
+
+            if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0 || size < sizeof(SignatureCatalogHeader))
+            {
+                throw std::runtime_error("Invalid signature catalog (misaligned or too small)");
+            }
+
+            m_Header = reinterpret_cast<const SignatureCatalogHeader *>(m_Data);
+            if (std::memcmp(m_Header->m_Magic, SignatureCatalogMagic, sizeof(SignatureCatalogMagic)) != 0)
+            {
+                throw std::runtime_error("Invalid signature catalog (bad magic number)");
+            }
+            if (m_Header->m_Version != SignatureCatalogVersion_v)
+            {
+                throw std::runtime_error("Unsupported signature catalog version " + std::to_string(m_Header->m_Version));
+            }
+            if (m_Header->m_CharSize != sizeof(tchar))
+            {
+                throw std::runtime_error("Signature catalog character size mismatch");
+            }
+
+            const std::uint32_t bucketCount = m_Header->m_BucketCount;
+            if (bucketCount == 0 ||
+                (bucketCount & (bucketCount - 1)) != 0 ||
+                bucketCount <= m_Header->m_EntryCount ||
+                m_Header->m_FileSize > size ||
+                !IsSectionValid(m_Header->m_BucketsOffset, bucketCount, sizeof(std::uint32_t), alignof(std::uint32_t)) ||
+                !IsSectionValid(m_Header->m_EntriesOffset, m_Header->m_EntryCount, sizeof(SignatureCatalogEntry), alignof(SignatureCatalogEntry)) ||
+                !IsSectionValid(m_Header->m_ArgsOffset, m_Header->m_ArgCount, sizeof(SignatureCatalogArg), alignof(SignatureCatalogArg)) ||
+                !IsSectionValid(m_Header->m_StringsOffset, m_Header->m_StringsSize, 1, alignof(tchar)))
+            {
+                throw std::runtime_error("Invalid signature catalog (section out of bounds)");
+            }
+
+            m_Buckets = reinterpret_cast<const std::uint32_t *>(m_Data + m_Header->m_BucketsOffset);
+            m_Entries = reinterpret_cast<const SignatureCatalogEntry *>(m_Data + m_Header->m_EntriesOffset);
+            m_Args = reinterpret_cast<const SignatureCatalogArg *>(m_Data + m_Header->m_ArgsOffset);
+            m_Strings = m_Data + m_Header->m_StringsOffset;
+        }
+
+        std::size_t GetEntryCount() const noexcept
+        {
+            return m_Header->m_EntryCount;
+        }
+
+        // "index" must be less than "GetEntryCount()"
+        Entry GetEntry(std::size_t index) const noexcept
+        {
+            return Entry(this, m_Entries + index);
+        }
+
+        ////////////////////////////////////////////////////////
+        // Returns the (first) entry whose signature hash is
+        // "hash" (normally "SignatureHash_v<F>"), or a null
+        // entry if not found (test via "operator bool"). O(1).
+        ////////////////////////////////////////////////////////
+        Entry Find(std::uint64_t hash) const noexcept
+        {
+            const std::uint32_t mask = m_Header->m_BucketCount - 1;
+
+            std::uint32_t bucket = static_cast<std::uint32_t>(hash) & mask;
+            for (std::uint32_t probe = 0; probe <= mask; ++probe)
+            {
+                const std::uint32_t entryIndex = m_Buckets[bucket];
+                if (entryIndex == 0 || entryIndex > m_Header->m_EntryCount)
+                {
+                    break;
+                }
+
+                const Private::SignatureCatalogEntry *const entry = m_Entries + (entryIndex - 1);
+                if (entry->m_Hash == hash)
+                {
+                    return Entry(this, entry);
+                }
+
+                bucket = (bucket + 1) & mask;
+            }
+
+            return Entry(this, nullptr);
+        }
+
+        template <TRAITS_FUNCTION_C F>
+        Entry Find() const noexcept
+        {
+            return Find(SignatureHash_v<F>);
+        }
+
+    private:
+        bool IsSectionValid(std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, std::uint64_t alignment) const noexcept
+        {
+            return offset % alignment == 0 &&
+                   offset <= m_Header->m_FileSize &&
+                   count <= (m_Header->m_FileSize - offset) / elementSize;
+        }
+
+        bool IsArgRangeValid(std::uint32_t firstArg, std::uint32_t argCount) const noexcept
+        {
+            return firstArg <= m_Header->m_ArgCount && argCount <= m_Header->m_ArgCount - firstArg;
+        }
+
+        template <typename CharT>
+        std::basic_string_view<CharT> GetString(const Private::SignatureCatalogString& str) const noexcept
+        {
+            if (str.m_Offset % sizeof(CharT) != 0 ||
+                str.m_Offset > m_Header->m_StringsSize ||
+                str.m_Length > (m_Header->m_StringsSize - str.m_Offset) / sizeof(CharT))
+            {
+                return {};
+            }
+
+            return std::basic_string_view<CharT>(reinterpret_cast<const CharT *>(m_Strings + str.m_Offset), str.m_Length);
+        }
+
+        const std::byte *m_Data;
+        const Private::SignatureCatalogHeader *m_Header;
+        const std::uint32_t *m_Buckets;
+        const Private::SignatureCatalogEntry *m_Entries;
+        const Private::SignatureCatalogArg *m_Args;
+        const std::byte *m_Strings;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // MappedSignatureCatalog. Memory maps a signature catalog file (read only)
+    // and opens a "SignatureCatalogView" over it. Throws "std::runtime_error"
+    // if the file can't be mapped or isn't a valid catalog.
+    /////////////////////////////////////////////////////////////////////////////
+    class MappedSignatureCatalog
+    {
+    public:
+        explicit MappedSignatureCatalog(const std::string& path)
+            : m_Mapping(path),
+              m_View(m_Mapping.m_Data, m_Mapping.m_Size)
+        {
+        }
+
+        MappedSignatureCatalog(const MappedSignatureCatalog&) = delete;
+        MappedSignatureCatalog& operator=(const MappedSignatureCatalog&) = delete;
+
+        const SignatureCatalogView& GetView() const noexcept
+        {
+            return m_View;
+        }
+
+        const SignatureCatalogView* operator->() const noexcept
+        {
+            return &m_View;
+        }
+
+    private:
+        ////////////////////////////////////////////////////////
+        // Owns the mapping (so it's released even if opening
+        // the view throws)
+        ////////////////////////////////////////////////////////
+        struct FileMapping
+        {
+            explicit FileMapping(const std::string& path)
+            {
+                #if defined(_WIN32)
+                    const HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                    if (file == INVALID_HANDLE_VALUE)
+                    {
+                        throw std::runtime_error("Unable to open signature catalog: " + path);
+                    }
+
+                    LARGE_INTEGER fileSize;
+                    const HANDLE mapping = ::GetFileSizeEx(file, &fileSize) && fileSize.QuadPart != 0
+                                           ? ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                                           : nullptr;
+                    ::CloseHandle(file);
+                    if (!mapping)
+                    {
+                        throw std::runtime_error("Unable to map signature catalog: " + path);
+                    }
+
+                    m_Data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    ::CloseHandle(mapping);
+                    if (!m_Data)
+                    {
+                        throw std::runtime_error("Unable to map signature catalog: " + path);
+                    }
+
+                    m_Size = static_cast<std::size_t>(fileSize.QuadPart);
+                #else
+                    const int file = ::open(path.c_str(), O_RDONLY);
+                    if (file < 0)
+                    {
+                        throw std::runtime_error("Unable to open signature catalog: " + path);
+                    }
+
+                    struct stat fileStatus;
+                    if (::fstat(file, &fileStatus) != 0 || fileStatus.st_size <= 0)
+                    {
+                        ::close(file);
+                        throw std::runtime_error("Unable to map signature catalog: " + path);
+                    }
+
+                    m_Size = static_cast<std::size_t>(fileStatus.st_size);
+                    void *const data = ::mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, file, 0);
+                    ::close(file);
+                    if (data == MAP_FAILED)
+                    {
+                        throw std::runtime_error("Unable to map signature catalog: " + path);
+                    }
+
+                    m_Data = data;
+                #endif
+            }
+
+            FileMapping(const FileMapping&) = delete;
+            FileMapping& operator=(const FileMapping&) = delete;
+
+            ~FileMapping()
+            {
+                #if defined(_WIN32)
+                    ::UnmapViewOfFile(m_Data);
+                #else
+                    ::munmap(m_Data, m_Size);
+                #endif
+            }
+
+            void *m_Data = nullptr;
+            std::size_t m_Size = 0;
+        };
+
+        FileMapping m_Mapping;
+        SignatureCatalogView m_View;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef FUNCTION_REGISTRY (#include guard)
@@ -98,6 +98,8 @@ export namespace StdExt
     using StdExt::AlwaysFalse_v;
     using StdExt::AlwaysTrue_v;
     using StdExt::TypeName_v;
+    using StdExt::Fnv1aHash;
+    using StdExt::TypeNameHash_v;
 
     #if defined(USE_CONCEPTS)
         using StdExt::IsFunction_c;
@@ -338,6 +338,7 @@
     #include <algorithm>
     #include <array>
     #include <cstddef>
+    #include <cstdint>
     #include <functional>
     #include <iostream>
     #include <string_view>
@@ -2350,6 +2351,44 @@ namespace StdExt
     ///////////////////////////////////////////////////////////////////////////
     template <typename T>
     inline constexpr tstring_view TypeName_v = Private::TypeNameImpl<T>::Get();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Fnv1aHash(). Returns the 64 bit FNV-1a hash of "str", computed at
+    // compile time when "str" is a constant expression (such as the string
+    // returned by "TypeName_v" above). Each character is hashed one byte at
+    // a time in little endian order regardless of "CharT" (so narrow and
+    // wide strings with the same ASCII content produce different hashes,
+    // since the number of bytes hashed differs). Optionally pass the result
+    // of a previous call in "hash" to hash several strings in sequence.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename CharT>
+    constexpr std::uint64_t Fnv1aHash(std::basic_string_view<CharT> str,
+                                      std::uint64_t hash = 14695981039346656037ull) noexcept
+    {
+        for (const CharT ch : str)
+        {
+            const auto value = static_cast<std::make_unsigned_t<CharT>>(ch);
+            for (std::size_t i = 0; i < sizeof(CharT); ++i)
+            {
+                hash ^= static_cast<std::uint64_t>((value >> (i * 8)) & 0xFF);
+                hash *= 1099511628211ull;
+            }
+        }
+
+        return hash;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // TypeNameHash_v. Variable template that returns the "Fnv1aHash()" of
+    // "TypeName_v<T>" (see both above), i.e., a compile-time 64 bit hash of
+    // the name of type "T". Useful as a compact identifier for a type (such
+    // as a function signature) but note that since "TypeName_v" itself is
+    // compiler-specific, the hash of a given type is only stable across
+    // binaries built with the same compiler (and is subject to collisions
+    // like any other hash, which callers should check for if required).
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    inline constexpr std::uint64_t TypeNameHash_v = Fnv1aHash(TypeName_v<T>);
 #endif // #if !defined(DECLARE_PUBLIC_MACROS_ONLY)
 
     // See this #defined constant for details
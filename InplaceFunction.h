@@ -0,0 +1,579 @@
+#ifndef INPLACE_FUNCTION
+#define INPLACE_FUNCTION
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "InplaceFunction", an owning,
+// move-only callable wrapper (similar in spirit to "std::function" or C++23
+// "std::move_only_function") whose target is always stored inline, in a
+// fixed-size buffer whose capacity is specified at compile time. Unlike
+// "std::function" there is no heap fallback. Attempting to store a target
+// whose size (or alignment) exceeds the buffer's capacity (or alignment) is
+// a compile-time error instead, so constructing, moving and invoking an
+// "InplaceFunction" is guaranteed never to allocate. This makes it suitable
+// for latency-critical code such as event loops where callbacks must be
+// stored without touching the heap.
+//
+// The wrapper's signature is obtained from "FunctionTraits" (see
+// "FunctionTraits.h"), so the "F" template arg can be any function type
+// supported by the latter library. Normally you'll pass a plain function
+// type however, optionally an "abominable" one (one with cv and/or ref
+// qualifiers) to specify the qualifiers of "InplaceFunction::operator()"
+// itself (and the way the target is invoked). E.g.:
+//
+//     InplaceFunction<int (float)> f1;                        // "operator()" is non-const (target invoked as an lvalue)
+//     InplaceFunction<int (float) const> f2;                  // "operator()" is const (target invoked as a const lvalue)
+//     InplaceFunction<int (float) && noexcept> f3;            // "operator()" is "&&" and "noexcept" (target invoked as an rvalue)
+//     InplaceFunction<decltype(someLambda), 64> f4;           // Signature (including "const" and "noexcept") taken from the
+//                                                             // lambda's "operator()", with an inline capacity of 64 bytes
+//
+// Dispatch to the target is through a small per-target table of function
+// pointers (a static "constexpr" table, one per target type), not through a
+// virtual function, so each "InplaceFunction" object is just its inline
+// buffer plus a single pointer to that table.
+//
+// Note that all declarations in this file are declared in namespace
+// "StdExt" (following the same conventions as "FunctionTraits.h").
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <cstring>
+    #include <exception>
+    #include <functional>
+    #include <new>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    //////////////////////////////////////////////////////////////////
+    // Default inline capacity (in bytes) of "InplaceFunction" when
+    // not explicitly specified. Large enough to hold a lambda that
+    // captures up to 3 pointers (or references), which covers the
+    // vast majority of callbacks in practice.
+    //////////////////////////////////////////////////////////////////
+    inline constexpr std::size_t InplaceFunctionDefaultCapacity_v = 3 * sizeof(void *);
+
+    namespace Private
+    {
+        /////////////////////////////////////////////////////////////////
+        // InvokeR(). Invokes "callable" with "args" converting the
+        // result to "R" (or discarding it if "R" is void). Same as
+        // C++23 "std::invoke_r" which isn't available in C++17/20.
+        /////////////////////////////////////////////////////////////////
+        template <typename R, typename CallableT, typename... ArgsT>
+        inline constexpr R InvokeR(CallableT&& callable, ArgsT&&... args)
+            noexcept(std::is_nothrow_invocable_r_v<R, CallableT, ArgsT...>)
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                std::invoke(std::forward<CallableT>(callable), std::forward<ArgsT>(args)...);
+            }
+            else
+            {
+                return std::invoke(std::forward<CallableT>(callable), std::forward<ArgsT>(args)...);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////
+        // InplaceFunctionStorage. Implementation of "InplaceFunction"
+        // (declared after this namespace) minus its "operator()" member,
+        // which is added by "InplaceFunctionCallOperator" further below
+        // (since its cv and ref qualifiers vary with the template args).
+        // The target is stored in "m_Storage" and manipulated through
+        // "m_Ops", which points to a static "constexpr" table specific to
+        // the target's type (see "TargetOps" below) or to "EmptyOps" when
+        // no target is stored (so "m_Ops" is never null, avoiding a null
+        // check on every call).
+        ////////////////////////////////////////////////////////////////////
+        template <typename R,
+                  typename ArgTypesTupleT,
+                  bool IsNoexcept,
+                  bool IsConst,
+                  FunctionReference FunctionReferenceT,
+                  std::size_t Capacity,
+                  std::size_t Alignment>
+        class InplaceFunctionStorage;
+
+        template <typename R,
+                  typename... ArgsT,
+                  bool IsNoexcept,
+                  bool IsConst,
+                  FunctionReference FunctionReferenceT,
+                  std::size_t Capacity,
+                  std::size_t Alignment>
+        class InplaceFunctionStorage<R, std::tuple<ArgsT...>, IsNoexcept, IsConst, FunctionReferenceT, Capacity, Alignment>
+        {
+            static_assert(Capacity > 0, "\"Capacity\" must be greater than zero");
+            static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "\"Alignment\" must be a power of 2");
+
+        public:
+            using ReturnType_t = R;
+            static constexpr bool IsNoexcept_v = IsNoexcept;
+            static constexpr std::size_t Capacity_v = Capacity;
+            static constexpr std::size_t Alignment_v = Alignment;
+
+        private:
+            ///////////////////////////////////////////////////////////
+            // Type of the function pointer in "Ops" used to invoke
+            // the target. Note that "noexcept" is part of the type
+            // so the compiler knows the call can't throw when
+            // "IsNoexcept" is true.
+            ///////////////////////////////////////////////////////////
+            using Invoke_t = R (*)(void *, ArgsT&&...) noexcept(IsNoexcept);
+
+            /////////////////////////////////////////////////////////////
+            // Per-target operations table. "m_Relocate" and "m_Destroy"
+            // are null for trivially copyable targets (in which case
+            // we simply copy "m_Size" bytes and skip destruction
+            // altogether), so moving a small lambda that captures a
+            // few pointers costs a "memcpy" of its size only.
+            /////////////////////////////////////////////////////////////
+            struct Ops
+            {
+                Invoke_t m_Invoke;
+                void (*m_Relocate)(void *to, void *from) noexcept; // Move constructs "to" from "from" then destroys "from"
+                void (*m_Destroy)(void *) noexcept;
+                std::size_t m_Size;
+            };
+
+            //////////////////////////////////////////////////////////////
+            // Invoked when no target is stored. Throws
+            // "std::bad_function_call" like "std::function" does, unless
+            // the signature is "noexcept" in which case we can't throw,
+            // so we call "std::terminate()" instead (invoking an empty
+            // "InplaceFunction" is always a bug).
+            //////////////////////////////////////////////////////////////
+            static R InvokeEmpty(void *, ArgsT&&...) noexcept(IsNoexcept)
+            {
+                if constexpr (IsNoexcept)
+                {
+                    std::terminate();
+                }
+                else
+                {
+                    throw std::bad_function_call();
+                }
+            }
+
+            template <typename TargetT>
+            static R InvokeTarget(void *storage, ArgsT&&... args) noexcept(IsNoexcept)
+            {
+                /////////////////////////////////////////////////////////
+                // Target is invoked as a const object if the signature
+                // is "const", and as an rvalue if the signature has
+                // the "&&" ref-qualifier (mirroring the qualifiers on
+                // our own "operator()").
+                /////////////////////////////////////////////////////////
+                using QualifiedTargetT = std::conditional_t<IsConst, const TargetT, TargetT>;
+                QualifiedTargetT &target = *std::launder(static_cast<TargetT *>(storage));
+
+                if constexpr (FunctionReferenceT == FunctionReference::RValue)
+                {
+                    return InvokeR<R>(std::move(target), std::forward<ArgsT>(args)...);
+                }
+                else
+                {
+                    return InvokeR<R>(target, std::forward<ArgsT>(args)...);
+                }
+            }
+
+            template <typename TargetT>
+            static void RelocateTarget(void *to, void *from) noexcept
+            {
+                TargetT &source = *std::launder(static_cast<TargetT *>(from));
+                ::new (to) TargetT(std::move(source));
+                source.~TargetT();
+            }
+
+            template <typename TargetT>
+            static void DestroyTarget(void *storage) noexcept
+            {
+                std::launder(static_cast<TargetT *>(storage))->~TargetT();
+            }
+
+            static constexpr Ops EmptyOps = { &InvokeEmpty, nullptr, nullptr, 0 };
+
+            template <typename TargetT>
+            static constexpr Ops TargetOps = { &InvokeTarget<TargetT>,
+                                               std::is_trivially_copyable_v<TargetT> ? nullptr : &RelocateTarget<TargetT>,
+                                               std::is_trivially_copyable_v<TargetT> ? nullptr : &DestroyTarget<TargetT>,
+                                               sizeof(TargetT) };
+
+            ///////////////////////////////////////////////////////////
+            // Type the target must be invocable as (given the
+            // qualifiers of the signature). See "InvokeTarget()"
+            // above.
+            ///////////////////////////////////////////////////////////
+            template <typename TargetT>
+            using InvokedAs_t = std::conditional_t<FunctionReferenceT == FunctionReference::RValue,
+                                                   std::conditional_t<IsConst, const TargetT &&, TargetT &&>,
+                                                   std::conditional_t<IsConst, const TargetT &, TargetT &>>;
+
+            template <typename TargetT>
+            static constexpr bool IsInvocable_v = IsNoexcept ? std::is_nothrow_invocable_r_v<R, InvokedAs_t<TargetT>, ArgsT...>
+                                                             : std::is_invocable_r_v<R, InvokedAs_t<TargetT>, ArgsT...>;
+
+        public:
+            //////////////////////////////////////////////////////////////
+            // Kicks in for any type "TargetT" that (after decaying) is
+            // invocable with our signature, excluding "InplaceFunction"
+            // itself and "std::in_place_type_t" (handled by their own
+            // constructors)
+            //////////////////////////////////////////////////////////////
+            template <typename TargetT>
+            static constexpr bool IsTargetConstructible_v = !std::is_base_of_v<InplaceFunctionStorage, std::decay_t<TargetT>> &&
+                                                            !IsSpecialization_v<std::decay_t<TargetT>, std::in_place_type_t> &&
+                                                            std::is_constructible_v<std::decay_t<TargetT>, TargetT> &&
+                                                            IsInvocable_v<std::decay_t<TargetT>>;
+
+            InplaceFunctionStorage() noexcept = default;
+
+            InplaceFunctionStorage(std::nullptr_t) noexcept
+            {
+            }
+
+            template <typename TargetT,
+                      typename = std::enable_if_t<IsTargetConstructible_v<TargetT>>>
+            InplaceFunctionStorage(TargetT&& target) noexcept(std::is_nothrow_constructible_v<std::decay_t<TargetT>, TargetT>)
+            {
+                Construct<std::decay_t<TargetT>>(std::forward<TargetT>(target));
+            }
+
+            template <typename TargetT,
+                      typename... CtorArgsT>
+            explicit InplaceFunctionStorage(std::in_place_type_t<TargetT>, CtorArgsT&&... ctorArgs)
+                noexcept(std::is_nothrow_constructible_v<TargetT, CtorArgsT...>)
+            {
+                Construct<TargetT>(std::forward<CtorArgsT>(ctorArgs)...);
+            }
+
+            InplaceFunctionStorage(InplaceFunctionStorage&& other) noexcept
+            {
+                RelocateFrom(other);
+            }
+
+            InplaceFunctionStorage& operator=(InplaceFunctionStorage&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    RelocateFrom(other);
+                }
+
+                return *this;
+            }
+
+            InplaceFunctionStorage& operator=(std::nullptr_t) noexcept
+            {
+                Reset();
+                return *this;
+            }
+
+            //////////////////////////////////////////////////////////////
+            // Assigns a new target. Note that the current target (if
+            // any) is destroyed first since there's only room for one
+            // target in our inline buffer, so if constructing the new
+            // target throws, this object is left empty.
+            //////////////////////////////////////////////////////////////
+            template <typename TargetT,
+                      typename = std::enable_if_t<IsTargetConstructible_v<TargetT>>>
+            InplaceFunctionStorage& operator=(TargetT&& target) noexcept(std::is_nothrow_constructible_v<std::decay_t<TargetT>, TargetT>)
+            {
+                Reset();
+                Construct<std::decay_t<TargetT>>(std::forward<TargetT>(target));
+                return *this;
+            }
+
+            InplaceFunctionStorage(const InplaceFunctionStorage&) = delete;
+            InplaceFunctionStorage& operator=(const InplaceFunctionStorage&) = delete;
+
+            ~InplaceFunctionStorage()
+            {
+                Reset();
+            }
+
+            template <typename TargetT,
+                      typename... CtorArgsT>
+            TargetT& Emplace(CtorArgsT&&... ctorArgs) noexcept(std::is_nothrow_constructible_v<TargetT, CtorArgsT...>)
+            {
+                Reset();
+                Construct<TargetT>(std::forward<CtorArgsT>(ctorArgs)...);
+                return *std::launder(reinterpret_cast<TargetT *>(m_Storage));
+            }
+
+            void Reset() noexcept
+            {
+                if (m_Ops->m_Destroy)
+                {
+                    m_Ops->m_Destroy(m_Storage);
+                }
+
+                m_Ops = &EmptyOps;
+            }
+
+            void Swap(InplaceFunctionStorage& other) noexcept
+            {
+                if (this != &other)
+                {
+                    InplaceFunctionStorage temp(std::move(other));
+                    other = std::move(*this);
+                    *this = std::move(temp);
+                }
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return m_Ops != &EmptyOps;
+            }
+
+            friend bool operator==(const InplaceFunctionStorage& function, std::nullptr_t) noexcept
+            {
+                return !function;
+            }
+
+            friend bool operator==(std::nullptr_t, const InplaceFunctionStorage& function) noexcept
+            {
+                return !function;
+            }
+
+            friend bool operator!=(const InplaceFunctionStorage& function, std::nullptr_t) noexcept
+            {
+                return static_cast<bool>(function);
+            }
+
+            friend bool operator!=(std::nullptr_t, const InplaceFunctionStorage& function) noexcept
+            {
+                return static_cast<bool>(function);
+            }
+
+        protected:
+            ////////////////////////////////////////////////////////////
+            // Invoked by "operator()" in the derived class. Always
+            // "const" since "operator()" may or may not be (depending
+            // on the signature), but the target itself is only
+            // treated as "const" when the signature is (see
+            // "InvokeTarget()")
+            ////////////////////////////////////////////////////////////
+            R Invoke(ArgsT&&... args) const noexcept(IsNoexcept)
+            {
+                return m_Ops->m_Invoke(const_cast<std::byte *>(m_Storage), std::forward<ArgsT>(args)...);
+            }
+
+        private:
+            template <typename TargetT,
+                      typename... CtorArgsT>
+            void Construct(CtorArgsT&&... ctorArgs) noexcept(std::is_nothrow_constructible_v<TargetT, CtorArgsT...>)
+            {
+                ///////////////////////////////////////////////////////
+                // The whole point of this class (no heap fallback).
+                // Increase the "Capacity" (and/or "Alignment")
+                // template arg if these trigger.
+                ///////////////////////////////////////////////////////
+                static_assert(sizeof(TargetT) <= Capacity,
+                              "Target is too large for this \"InplaceFunction\" (its size exceeds the \"Capacity\" "
+                              "template arg). Increase \"Capacity\" or reduce the size of the target (e.g., capture "
+                              "less state in your lambda).");
+                static_assert(alignof(TargetT) <= Alignment,
+                              "Target's alignment exceeds the \"Alignment\" template arg of this \"InplaceFunction\"");
+                static_assert(std::is_nothrow_move_constructible_v<TargetT>,
+                              "Targets stored in an \"InplaceFunction\" must be nothrow move constructible (so "
+                              "that moving an \"InplaceFunction\" can never throw)");
+                static_assert(IsInvocable_v<TargetT>,
+                              "Target isn't invocable with the signature of this \"InplaceFunction\"");
+
+                //////////////////////////////////////////////////////
+                // Null function pointers and null member function
+                // pointers result in an empty "InplaceFunction"
+                // (consistent with "std::function")
+                //////////////////////////////////////////////////////
+                if constexpr (sizeof...(CtorArgsT) == 1 &&
+                              (std::is_pointer_v<TargetT> || std::is_member_pointer_v<TargetT>))
+                {
+                    if (((ctorArgs == nullptr) && ...))
+                    {
+                        return;
+                    }
+                }
+
+                ::new (static_cast<void *>(m_Storage)) TargetT(std::forward<CtorArgsT>(ctorArgs)...);
+                m_Ops = &TargetOps<TargetT>;
+            }
+
+            /////////////////////////////////////////////////////////
+            // Moves the target of "other" into our (empty) storage
+            // leaving "other" empty
+            /////////////////////////////////////////////////////////
+            void RelocateFrom(InplaceFunctionStorage& other) noexcept
+            {
+                if (other.m_Ops->m_Relocate)
+                {
+                    other.m_Ops->m_Relocate(m_Storage, other.m_Storage);
+                }
+                else if (other.m_Ops->m_Size != 0)
+                {
+                    std::memcpy(m_Storage, other.m_Storage, other.m_Ops->m_Size);
+                }
+
+                m_Ops = other.m_Ops;
+                other.m_Ops = &EmptyOps;
+            }
+
+            alignas(Alignment) std::byte m_Storage[Capacity];
+            const Ops *m_Ops = &EmptyOps;
+        };
+
+        /////////////////////////////////////////////////////////////////
+        // InplaceFunctionCallOperator. Adds "operator()" to the
+        // "InplaceFunctionStorage" class passed via "BaseT", with the
+        // cv and ref qualifiers of the signature (one specialization
+        // per combination, created by the macro below). Note that
+        // "volatile" isn't supported (we reject it in
+        // "InplaceFunction" itself).
+        /////////////////////////////////////////////////////////////////
+        template <typename BaseT,
+                  bool IsConst,
+                  FunctionReference FunctionReferenceT,
+                  typename ArgTypesTupleT>
+        class InplaceFunctionCallOperator;
+
+        // For internal use only (we #undef it later)
+        #define DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(IS_CONST, CONST, FUNCTION_REFERENCE, REF) \
+            template <typename BaseT, \
+                      typename... ArgsT> \
+            class InplaceFunctionCallOperator<BaseT, \
+                                              IS_CONST, \
+                                              FunctionReference::FUNCTION_REFERENCE, \
+                                              std::tuple<ArgsT...> \
+                                             > : public BaseT \
+            { \
+            public: \
+                using BaseT::BaseT; \
+                using BaseT::operator=; \
+\
+                typename BaseT::ReturnType_t operator()(ArgsT... args) CONST REF noexcept(BaseT::IsNoexcept_v) \
+                { \
+                    return BaseT::Invoke(std::forward<ArgsT>(args)...); \
+                } \
+            };
+
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(false,      , None,   )
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(false,      , LValue, &)
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(false,      , RValue, &&)
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(true,  const, None,   )
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(true,  const, LValue, &)
+        DECLARE_INPLACE_FUNCTION_CALL_OPERATOR(true,  const, RValue, &&)
+
+        // Done with this (for internal use only)
+        #undef DECLARE_INPLACE_FUNCTION_CALL_OPERATOR
+
+        template <typename F,
+                  std::size_t Capacity,
+                  std::size_t Alignment>
+        using InplaceFunctionBase_t = InplaceFunctionCallOperator<InplaceFunctionStorage<ReturnType_t<F>,
+                                                                                         ArgTypes_t<F>,
+                                                                                         IsNoexcept_v<F>,
+                                                                                         IsFunctionConst_v<F>,
+                                                                                         FunctionReference_v<F>,
+                                                                                         Capacity,
+                                                                                         Alignment>,
+                                                                  IsFunctionConst_v<F>,
+                                                                  FunctionReference_v<F>,
+                                                                  ArgTypes_t<F>>;
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // InplaceFunction. Owning, move-only callable wrapper with inline storage
+    // only (never allocates). See top of this file for details. Template args
+    // are as follows:
+    //
+    //    F - The signature of "operator()" which can be any function type
+    //        supported by "FunctionTraits" (its return type, arg types,
+    //        "noexcept" specification and "const" and ref qualifiers are
+    //        used - variadic and "volatile" functions aren't supported).
+    //        Normally a plain (possibly abominable) function type such as
+    //        "void (int) const noexcept".
+    //    Capacity - Size of the inline buffer in bytes. Storing a target
+    //               whose "sizeof" exceeds this results in a compile-time
+    //               error (never a heap allocation).
+    //    Alignment - Alignment of the inline buffer. Storing a target whose
+    //                "alignof" exceeds this results in a compile-time error.
+    //
+    // Targets must be nothrow move constructible. Invoking an empty
+    // "InplaceFunction" throws "std::bad_function_call", or calls
+    // "std::terminate()" if "F" is "noexcept". Null function pointers (or
+    // null member function pointers) result in an empty "InplaceFunction",
+    // consistent with "std::function".
+    //
+    //     InplaceFunction<void (int) noexcept, 16> callback = [this](int value) noexcept
+    //                                                          {
+    //                                                              OnValue(value);
+    //                                                          };
+    //     callback(10);
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F,
+              std::size_t Capacity = InplaceFunctionDefaultCapacity_v,
+              std::size_t Alignment = alignof(std::max_align_t)>
+    class InplaceFunction : public Private::InplaceFunctionBase_t<F, Capacity, Alignment>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(!IsVariadic_v<F>, "Variadic functions aren't supported by \"InplaceFunction\"");
+        static_assert(!IsFunctionVolatile_v<F>, "\"volatile\" functions aren't supported by \"InplaceFunction\"");
+
+        using BaseClass = Private::InplaceFunctionBase_t<F, Capacity, Alignment>;
+
+    public:
+        using BaseClass::BaseClass;
+        using BaseClass::operator=;
+    };
+
+    template <TRAITS_FUNCTION_C F,
+              std::size_t Capacity,
+              std::size_t Alignment>
+    inline void swap(InplaceFunction<F, Capacity, Alignment>& function1,
+                     InplaceFunction<F, Capacity, Alignment>& function2) noexcept
+    {
+        function1.Swap(function2);
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef INPLACE_FUNCTION (#include guard)
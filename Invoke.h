@@ -0,0 +1,292 @@
+#ifndef INVOKE
+#define INVOKE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring "Invoke()" and "Normalize()", which invoke (or
+// prepare for invocation) any callable supported by "FunctionTraits" (see
+// "FunctionTraits.h") through its cheapest call path, relying on
+// "FunctionOrigin_v" to classify the callable at compile time:
+//
+// 1) FunctionOrigin::StaticFunctor - Functors whose "operator()" is
+//    "static" (C++23 or later) are called without an object, i.e., via
+//    "F::operator()(args...)" (and "Normalize()" returns a plain function
+//    pointer to it, so it's no different than a free function from then
+//    on).
+// 2) FunctionOrigin::StdFunction - "Normalize()" checks once (via
+//    "std::function::target()", using "StdFunctionTemplateArg_t" to
+//    determine the target's function pointer type) whether the
+//    "std::function" simply wraps a plain function pointer and if so,
+//    caches it so subsequent calls go directly through the pointer,
+//    bypassing the type erasure machinery of "std::function" (falling back
+//    to the "std::function" itself otherwise). See "NormalizedStdFunction"
+//    below.
+// 3) FunctionOrigin::Functor - Functors (including lambdas) are called
+//    directly (never through "std::function" or any other wrapper) so the
+//    compiler can inline them.
+// 4) FunctionOrigin::None (free functions and non-static member
+//    functions) - Free functions are called directly and non-static member
+//    function pointers are invoked on their object (passed as the first
+//    arg), as per "std::invoke()".
+//
+// Generic dispatch code can therefore call "Invoke()" wherever it would
+// normally call "std::invoke()" (it's a drop-in replacement), or
+// "Normalize()" any callable once up front and then repeatedly invoke the
+// result (the usual pattern for callbacks invoked many times).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <functional>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // FunctionOriginOf_v. Same as "FunctionOrigin_v<F>" for
+        // any "F" supported by "FunctionTraits", or
+        // "FunctionOrigin::None" otherwise (e.g., for overloaded
+        // functors such as generic lambdas, which we still invoke
+        // directly)
+        ////////////////////////////////////////////////////////////
+        template <typename F>
+        constexpr FunctionOrigin GetFunctionOrigin() noexcept
+        {
+            if constexpr (IsTraitsFunction_v<F>)
+            {
+                return FunctionOrigin_v<F>;
+            }
+            else
+            {
+                return FunctionOrigin::None;
+            }
+        }
+
+        template <typename F>
+        inline constexpr FunctionOrigin FunctionOriginOf_v = GetFunctionOrigin<RemoveCvRef_t<F>>();
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // NormalizedStdFunction. Non-owning view of a "std::function" returned by
+    // "Normalize()" (never normally created directly). If the "std::function"
+    // wraps a plain function pointer then it's cached at construction
+    // (extracted via "std::function::target()", which relies on RTTI) and
+    // invoked directly from then on, otherwise the "std::function" itself is
+    // invoked. "F" is the "std::function" template arg (the function type
+    // "R (ArgsT...)", normally obtained via "StdFunctionTemplateArg_t"). Note
+    // that the "std::function" must outlive this object and must not be
+    // assigned a new target while this object is in use (since the cached
+    // function pointer would then be stale).
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    class NormalizedStdFunction;
+
+    template <typename R,
+              typename... ArgsT>
+    class NormalizedStdFunction<R (ArgsT...)>
+    {
+    public:
+        using StdFunction_t = std::function<R (ArgsT...)>;
+        using FunctionPointer_t = R (*)(ArgsT...);
+
+        explicit NormalizedStdFunction(const StdFunction_t& stdFunction) noexcept
+            : m_FunctionPointer(GetFunctionPointer(stdFunction)),
+              m_StdFunction(&stdFunction)
+        {
+        }
+
+        R operator()(ArgsT... args) const
+        {
+            if (m_FunctionPointer)
+            {
+                return m_FunctionPointer(std::forward<ArgsT>(args)...);
+            }
+
+            return (*m_StdFunction)(std::forward<ArgsT>(args)...);
+        }
+
+        ////////////////////////////////////////////////////////
+        // Returns true if the "std::function" wraps a plain
+        // function pointer (which we invoke directly), false
+        // otherwise
+        ////////////////////////////////////////////////////////
+        bool IsUnwrapped() const noexcept
+        {
+            return m_FunctionPointer != nullptr;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(*m_StdFunction);
+        }
+
+    private:
+        static FunctionPointer_t GetFunctionPointer(const StdFunction_t& stdFunction) noexcept
+        {
+            //////////////////////////////////////////////////////////
+            // Note: "target()" returns null for empty "std::function"
+            // objects and whenever the target isn't exactly of the
+            // given type. We therefore also check for "noexcept"
+            // function pointers (a distinct type since C++17),
+            // which implicitly convert to our (non-noexcept)
+            // function pointer type.
+            //////////////////////////////////////////////////////////
+            if (const FunctionPointer_t *const functionPointer = stdFunction.template target<FunctionPointer_t>())
+            {
+                return *functionPointer;
+            }
+
+            using NoexceptFunctionPointer_t = R (*)(ArgsT...) noexcept;
+            if (const NoexceptFunctionPointer_t *const functionPointer = stdFunction.template target<NoexceptFunctionPointer_t>())
+            {
+                return *functionPointer;
+            }
+
+            return nullptr;
+        }
+
+        FunctionPointer_t m_FunctionPointer;
+        const StdFunction_t *m_StdFunction;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Invoke(). Drop-in replacement for "std::invoke()" that invokes "f" via
+    // its cheapest call form based on its "FunctionOrigin_v" (see top of this
+    // file). Note that "std::function" objects are simply invoked as usual
+    // here (checking their target on every call would defeat the purpose) so
+    // pass them through "Normalize()" first if they'll be invoked repeatedly.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename... ArgsT>
+    constexpr decltype(auto) Invoke(F&& f, ArgsT&&... args) noexcept(std::is_nothrow_invocable_v<F, ArgsT...>)
+    {
+        using DecayF = RemoveCvRef_t<F>;
+
+        if constexpr (Private::FunctionOriginOf_v<F> == FunctionOrigin::StaticFunctor)
+        {
+            ///////////////////////////////////////////////////
+            // Static "operator()" (C++23). Call it without an
+            // object (so "f" itself is never even touched)
+            ///////////////////////////////////////////////////
+            return DecayF::operator()(std::forward<ArgsT>(args)...);
+        }
+        else if constexpr (std::is_member_pointer_v<DecayF>)
+        {
+            ///////////////////////////////////////////////////
+            // Non-static member function pointer (or member
+            // data pointer), invoked on the object in the
+            // first arg (which "std::invoke()" already handles
+            // optimally, including objects passed by pointer
+            // or "std::reference_wrapper")
+            ///////////////////////////////////////////////////
+            return std::invoke(std::forward<F>(f), std::forward<ArgsT>(args)...);
+        }
+        else
+        {
+            //////////////////////////////////////////////////////
+            // Free functions (including pointers and references
+            // to them) and functors (including "std::function"
+            // and "NormalizedStdFunction"). Called directly.
+            //////////////////////////////////////////////////////
+            return std::forward<F>(f)(std::forward<ArgsT>(args)...);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // InvokeStatic(). Invokes static functor "F" (C++23 or later) without an
+    // object, i.e., "F::operator()(args...)"
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename... ArgsT>
+    constexpr decltype(auto) InvokeStatic(ArgsT&&... args) noexcept(noexcept(RemoveCvRef_t<F>::operator()(std::forward<ArgsT>(args)...)))
+    {
+        static_assert(IsTraitsStaticFunctor_v<F>,
+                      "\"F\" must be a (non-overloaded) functor with a static \"operator()\"");
+
+        return RemoveCvRef_t<F>::operator()(std::forward<ArgsT>(args)...);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Normalize(). Converts "f" into the cheapest form for repeated
+    // invocation based on its "FunctionOrigin_v" (see top of this file). The
+    // result is always invocable with the same args as "f" (normally via
+    // "Invoke()" above, since non-static member function pointers are
+    // returned as is). Returns:
+    //
+    // 1) A plain function pointer to "F::operator()" if "f" is a static
+    //    functor (C++23 or later)
+    // 2) A "NormalizedStdFunction" referencing "f" if it's a
+    //    "std::function" (which must therefore be an lvalue that outlives
+    //    the returned object)
+    // 3) "f" itself otherwise, i.e., a reference to "f" if it's an lvalue,
+    //    or a copy of it (moved) if it's an rvalue
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    constexpr decltype(auto) Normalize(F&& f) noexcept(Private::FunctionOriginOf_v<F> == FunctionOrigin::StaticFunctor ||
+                                                       Private::FunctionOriginOf_v<F> == FunctionOrigin::StdFunction ||
+                                                       std::is_lvalue_reference_v<F> ||
+                                                       std::is_nothrow_move_constructible_v<RemoveCvRef_t<F>>)
+    {
+        using DecayF = RemoveCvRef_t<F>;
+        constexpr FunctionOrigin functionOrigin = Private::FunctionOriginOf_v<F>;
+
+        if constexpr (functionOrigin == FunctionOrigin::StaticFunctor)
+        {
+            return &DecayF::operator();
+        }
+        else if constexpr (functionOrigin == FunctionOrigin::StdFunction)
+        {
+            static_assert(std::is_lvalue_reference_v<F>,
+                          "\"std::function\" objects passed to \"Normalize()\" must be lvalues (since the "
+                          "returned \"NormalizedStdFunction\" references them)");
+
+            return NormalizedStdFunction<StdFunctionTemplateArg_t<DecayF>>(f);
+        }
+        else if constexpr (std::is_lvalue_reference_v<F>)
+        {
+            // Parentheses required so "decltype(auto)" deduces a reference
+            return (f);
+        }
+        else
+        {
+            return DecayF(std::move(f));
+        }
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef INVOKE (#include guard)
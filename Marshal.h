@@ -0,0 +1,530 @@
+#ifndef MARSHAL
+#define MARSHAL
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Marshal", which encodes the args
+// of a call to function "F" into a flat (caller-provided) byte buffer and
+// later decodes them directly into a call to "F" (or any compatible
+// callable), typically on another thread or in another process. The wire
+// layout is computed at compile time from the arg types of "F" (obtained
+// via "ArgTypes_t" in "FunctionTraits.h"):
+//
+//     +-------------------------------------------+---------+---------+
+//     | Fixed section: one field per arg of "F"   | Blob 1  | Blob 2  | ...
+//     | (in parameter order, each aligned)        |         |         |
+//     +-------------------------------------------+---------+---------+
+//
+// 1) Args whose (decayed) type is trivially copyable are stored in their
+//    field as is (copied via "std::memcpy()").
+// 2) "std::basic_string_view" args (and in C++20 or later, "std::span"
+//    args with "const", trivially copyable, non-pointer elements and
+//    dynamic extent) are stored as a "MarshalBlobRef" in their field,
+//    i.e., the offset (from the start of the buffer) and element count of
+//    a "blob" holding the actual characters (or elements), appended after
+//    the fixed section (each blob aligned for its element type).
+//
+// Decoding requires no intermediate "std::tuple" (or any other copy of the
+// args as a whole). Each arg is read from its field directly into the
+// corresponding parameter of the call, and "std::basic_string_view" and
+// "std::span" args simply point into the buffer itself (zero copy).
+//
+// Args of any other type (including pointers, which aren't meaningful
+// outside the encoding process, and non-const lvalue references, which
+// are output parameters) are rejected at compile time. Note that the
+// encoding uses the native byte order and native type layouts so it's
+// intended for communication on the same machine only (between threads
+// or between processes built with the same compiler and options), not as
+// a general purpose serialization format.
+//
+// Example:
+//
+//     void Log(int level, std::string_view message);
+//
+//     char buffer[256];
+//     const std::size_t size = Marshal<decltype(Log)>::Encode(buffer, sizeof(buffer), 3, "Hello");
+//
+//     // Later, possibly in another thread or process ...
+//     if (Marshal<decltype(Log)>::Validate(buffer, size))
+//     {
+//         Marshal<decltype(Log)>::DecodeAndInvoke(buffer, size, Log); // Calls "Log(3, "Hello")"
+//     }
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <algorithm>
+    #include <array>
+    #include <cassert>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <functional>
+    #if CPP20_OR_LATER
+        #include <span>
+    #endif
+    #include <string_view>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    /////////////////////////////////////////////////////////////////////////
+    // MarshalBlobRef. Field stored in the fixed section of a "Marshal"
+    // buffer for "std::basic_string_view" and "std::span" args, referencing
+    // the blob holding their elements elsewhere in the same buffer.
+    /////////////////////////////////////////////////////////////////////////
+    struct MarshalBlobRef
+    {
+        std::uint32_t m_Offset; // Offset of the blob from the start of the buffer
+        std::uint32_t m_Count;  // Number of elements in the blob (not bytes)
+    };
+
+    namespace Private
+    {
+        ///////////////////////////////////////////////////////////
+        // Rounds "value" up to the nearest multiple of "alignment"
+        // (which must be a power of 2)
+        ///////////////////////////////////////////////////////////
+        constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment) noexcept
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // MarshalBlobTraits. Specialized for each (decayed) arg
+        // type stored as a blob (see top of file), where
+        // "IsBlob_v" is true and "Element_t" is the type of each
+        // element in the blob.
+        ////////////////////////////////////////////////////////////
+        template <typename T>
+        struct MarshalBlobTraits
+        {
+            static constexpr bool IsBlob_v = false;
+        };
+
+        template <typename CharT,
+                  typename TraitsT>
+        struct MarshalBlobTraits<std::basic_string_view<CharT, TraitsT>>
+        {
+            static constexpr bool IsBlob_v = true;
+            using Element_t = CharT;
+
+            static constexpr std::basic_string_view<CharT, TraitsT> Make(const Element_t *data, std::size_t count) noexcept
+            {
+                return std::basic_string_view<CharT, TraitsT>(data, count);
+            }
+        };
+
+        #if CPP20_OR_LATER
+            template <typename T,
+                      std::size_t Extent>
+            struct MarshalBlobTraits<std::span<T, Extent>>
+            {
+                static_assert(std::is_const_v<T>,
+                              "\"std::span\" args passed to \"Marshal\" must have \"const\" elements "
+                              "(decoded spans point into the (read-only) buffer)");
+                static_assert(Extent == std::dynamic_extent,
+                              "\"std::span\" args passed to \"Marshal\" must have a dynamic extent");
+                static_assert(std::is_trivially_copyable_v<T> && !std::is_pointer_v<std::remove_cv_t<T>>,
+                              "\"std::span\" args passed to \"Marshal\" must have trivially copyable, non-pointer "
+                              "elements (the elements are copied into the buffer via \"std::memcpy()\")");
+
+                static constexpr bool IsBlob_v = true;
+                using Element_t = T;
+
+                static constexpr std::span<T, Extent> Make(const Element_t *data, std::size_t count) noexcept
+                {
+                    return std::span<T, Extent>(data, count);
+                }
+            };
+        #endif
+
+        template <typename T>
+        inline constexpr bool IsMarshalBlob_v = MarshalBlobTraits<T>::IsBlob_v;
+
+        ///////////////////////////////////////////////////////////
+        // Size and alignment of the field for an arg of
+        // (decayed) type "T" in the fixed section, and the
+        // alignment of its blob (if any)
+        ///////////////////////////////////////////////////////////
+        template <typename T>
+        inline constexpr std::size_t MarshalFieldSize_v = IsMarshalBlob_v<T> ? sizeof(MarshalBlobRef) : sizeof(T);
+
+        template <typename T>
+        inline constexpr std::size_t MarshalFieldAlignment_v = IsMarshalBlob_v<T> ? alignof(MarshalBlobRef) : alignof(T);
+
+        template <typename T>
+        constexpr std::size_t GetMarshalBlobAlignment() noexcept
+        {
+            if constexpr (IsMarshalBlob_v<T>)
+            {
+                return alignof(typename MarshalBlobTraits<T>::Element_t);
+            }
+            else
+            {
+                return 1;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////
+        // IsMarshallable. True if arg type "T" (the actual
+        // parameter type, not decayed) is supported by
+        // "Marshal" (see top of file)
+        ///////////////////////////////////////////////////////////
+        template <typename T>
+        inline constexpr bool IsMarshallable_v = !(std::is_lvalue_reference_v<T> && !std::is_const_v<std::remove_reference_t<T>>) &&
+                                                 !std::is_pointer_v<RemoveCvRef_t<T>> &&
+                                                 (IsMarshalBlob_v<RemoveCvRef_t<T>> ||
+                                                  std::is_trivially_copyable_v<RemoveCvRef_t<T>>);
+
+        ///////////////////////////////////////////////////////////////
+        // MarshalImpl. Implementation of "Marshal" (declared after
+        // this namespace), specialized on the arg types of "F".
+        ///////////////////////////////////////////////////////////////
+        template <typename ArgTypesTupleT>
+        class MarshalImpl;
+
+        template <typename... ArgsT>
+        class MarshalImpl<std::tuple<ArgsT...>>
+        {
+            static_assert((IsMarshallable_v<ArgsT> && ...),
+                          "All args of \"F\" passed to \"Marshal\" must be trivially copyable (after removing "
+                          "any reference and cv-qualifiers), or a \"std::basic_string_view\" or \"std::span\" "
+                          "(C++20 or later). Pointers and non-const lvalue references aren't supported.");
+
+            static constexpr std::size_t ArgCount = sizeof...(ArgsT);
+
+            template <std::size_t I>
+            using DecayedArg_t = RemoveCvRef_t<std::tuple_element_t<I, std::tuple<ArgsT...>>>;
+
+            ////////////////////////////////////////////////////////
+            // Offset of each arg's field in the fixed section
+            // (in parameter order, each aligned for its type)
+            ////////////////////////////////////////////////////////
+            static constexpr std::array<std::size_t, ArgCount> GetOffsets() noexcept
+            {
+                std::array<std::size_t, ArgCount> offsets{};
+                constexpr std::size_t sizes[] = {MarshalFieldSize_v<RemoveCvRef_t<ArgsT>>..., 0};
+                constexpr std::size_t alignments[] = {MarshalFieldAlignment_v<RemoveCvRef_t<ArgsT>>..., 1};
+
+                std::size_t offset = 0;
+                for (std::size_t i = 0; i < ArgCount; ++i)
+                {
+                    offset = AlignUp(offset, alignments[i]);
+                    offsets[i] = offset;
+                    offset += sizes[i];
+                }
+
+                return offsets;
+            }
+
+            static constexpr std::array<std::size_t, ArgCount> Offsets = GetOffsets();
+
+            static constexpr std::size_t GetFixedSize() noexcept
+            {
+                if constexpr (ArgCount == 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    return Offsets[ArgCount - 1] + MarshalFieldSize_v<DecayedArg_t<ArgCount - 1>>;
+                }
+            }
+
+        public:
+            ////////////////////////////////////////////////////////
+            // Size of the fixed section (in bytes). The size of
+            // the encoded call if there are no blobs.
+            ////////////////////////////////////////////////////////
+            static constexpr std::size_t FixedSize_v = GetFixedSize();
+
+            //////////////////////////////////////////////////////////
+            // Required alignment of the buffer passed to
+            // "DecodeAndInvoke()" (so fields can be read and blobs
+            // referenced in place)
+            //////////////////////////////////////////////////////////
+            static constexpr std::size_t Alignment_v = std::max({std::size_t{1},
+                                                                 MarshalFieldAlignment_v<RemoveCvRef_t<ArgsT>>...,
+                                                                 GetMarshalBlobAlignment<RemoveCvRef_t<ArgsT>>()...});
+
+            static constexpr bool HasBlobs_v = (IsMarshalBlob_v<RemoveCvRef_t<ArgsT>> || ...);
+
+            /////////////////////////////////////////////////////////
+            // Returns the number of bytes "Encode()" requires to
+            // encode the given args
+            /////////////////////////////////////////////////////////
+            static constexpr std::size_t EncodedSize(const RemoveCvRef_t<ArgsT>&... args) noexcept
+            {
+                std::size_t size = FixedSize_v;
+                (AddBlobSize(size, args), ...);
+                return size;
+            }
+
+            /////////////////////////////////////////////////////////
+            // Encodes the given args into "buffer" (which need not
+            // be aligned but should be aligned to "Alignment_v" if
+            // it will be passed to "DecodeAndInvoke()" without
+            // being copied first). Returns the number of bytes
+            // written, or zero if "capacity" is too small (in
+            // which case nothing is written).
+            /////////////////////////////////////////////////////////
+            static std::size_t Encode(void *buffer, std::size_t capacity, const RemoveCvRef_t<ArgsT>&... args) noexcept
+            {
+                const std::size_t size = EncodedSize(args...);
+                if (size > capacity || size > UINT32_MAX)
+                {
+                    return 0;
+                }
+
+                std::byte *const bytes = static_cast<std::byte *>(buffer);
+
+                // Zero the fixed section first so no (stale) padding bytes leak onto the wire
+                std::memset(bytes, 0, FixedSize_v);
+
+                std::size_t blobOffset = FixedSize_v;
+                EncodeArgs(bytes, blobOffset, std::index_sequence_for<ArgsT...>(), args...);
+
+                return size;
+            }
+
+            /////////////////////////////////////////////////////////
+            // Returns true if "buffer" (of "size" bytes) holds a
+            // well-formed encoding, i.e., it's suitably aligned,
+            // large enough for the fixed section, and every blob
+            // lies within "size" bytes after the fixed section
+            // (and is aligned). Buffers received from untrusted
+            // sources should always be validated before calling
+            // "DecodeAndInvoke()".
+            /////////////////////////////////////////////////////////
+            static bool Validate(const void *buffer, std::size_t size) noexcept
+            {
+                if (size < FixedSize_v ||
+                    (HasBlobs_v && reinterpret_cast<std::uintptr_t>(buffer) % Alignment_v != 0))
+                {
+                    return false;
+                }
+
+                return ValidateBlobs(static_cast<const std::byte *>(buffer), size, std::index_sequence_for<ArgsT...>());
+            }
+
+            /////////////////////////////////////////////////////////
+            // Decodes the args in "buffer" and invokes "f" with
+            // them, returning its result. "f" is invoked as per
+            // "std::invoke()" with "leadingArgs" first (if any,
+            // e.g., the object if "f" is a non-static member
+            // function pointer), followed by the decoded args.
+            // Each decoded arg is read directly from the buffer
+            // into the corresponding parameter ("std::basic_string_view"
+            // and "std::span" args point into "buffer" itself so it
+            // must remain valid until "f" returns). The buffer
+            // must be well-formed (see "Validate()").
+            /////////////////////////////////////////////////////////
+            template <typename CallableT,
+                      typename... LeadingArgsT>
+            static decltype(auto) DecodeAndInvoke(const void *buffer,
+                                                  [[maybe_unused]] std::size_t size,
+                                                  CallableT&& f,
+                                                  LeadingArgsT&&... leadingArgs)
+            {
+                assert(Validate(buffer, size));
+
+                return DecodeAndInvokeImpl(static_cast<const std::byte *>(buffer),
+                                           std::index_sequence_for<ArgsT...>(),
+                                           std::forward<CallableT>(f),
+                                           std::forward<LeadingArgsT>(leadingArgs)...);
+            }
+
+        private:
+            template <typename T>
+            static constexpr void AddBlobSize(std::size_t& size, const T& arg) noexcept
+            {
+                if constexpr (IsMarshalBlob_v<T>)
+                {
+                    using Element_t = typename MarshalBlobTraits<T>::Element_t;
+                    size = AlignUp(size, alignof(Element_t)) + arg.size() * sizeof(Element_t);
+                }
+            }
+
+            template <std::size_t... I>
+            static void EncodeArgs([[maybe_unused]] std::byte *bytes,
+                                   [[maybe_unused]] std::size_t& blobOffset,
+                                   std::index_sequence<I...>,
+                                   const RemoveCvRef_t<ArgsT>&... args) noexcept
+            {
+                (EncodeArg<I>(bytes, blobOffset, args), ...);
+            }
+
+            template <std::size_t I,
+                      typename T>
+            static void EncodeArg(std::byte *bytes, std::size_t& blobOffset, const T& arg) noexcept
+            {
+                if constexpr (IsMarshalBlob_v<T>)
+                {
+                    using Element_t = typename MarshalBlobTraits<T>::Element_t;
+
+                    // Zero the alignment gap before the blob (if any) so no (stale) bytes leak onto the wire
+                    const std::size_t alignedOffset = AlignUp(blobOffset, alignof(Element_t));
+                    std::memset(bytes + blobOffset, 0, alignedOffset - blobOffset);
+                    blobOffset = alignedOffset;
+
+                    const std::size_t byteCount = arg.size() * sizeof(Element_t);
+                    if (byteCount != 0)
+                    {
+                        std::memcpy(bytes + blobOffset, arg.data(), byteCount);
+                    }
+
+                    const MarshalBlobRef blobRef = {static_cast<std::uint32_t>(blobOffset),
+                                                    static_cast<std::uint32_t>(arg.size())};
+                    std::memcpy(bytes + Offsets[I], &blobRef, sizeof(blobRef));
+
+                    blobOffset += byteCount;
+                }
+                else
+                {
+                    std::memcpy(bytes + Offsets[I], &arg, sizeof(T));
+                }
+            }
+
+            template <std::size_t... I>
+            static bool ValidateBlobs([[maybe_unused]] const std::byte *bytes, [[maybe_unused]] std::size_t size, std::index_sequence<I...>) noexcept
+            {
+                return (ValidateBlob<I>(bytes, size) && ...);
+            }
+
+            template <std::size_t I>
+            static bool ValidateBlob([[maybe_unused]] const std::byte *bytes, [[maybe_unused]] std::size_t size) noexcept
+            {
+                using T = DecayedArg_t<I>;
+                if constexpr (IsMarshalBlob_v<T>)
+                {
+                    using Element_t = typename MarshalBlobTraits<T>::Element_t;
+
+                    MarshalBlobRef blobRef;
+                    std::memcpy(&blobRef, bytes + Offsets[I], sizeof(blobRef));
+
+                    return blobRef.m_Offset >= FixedSize_v &&
+                           blobRef.m_Offset % alignof(Element_t) == 0 &&
+                           blobRef.m_Offset <= size &&
+                           blobRef.m_Count <= (size - blobRef.m_Offset) / sizeof(Element_t);
+                }
+                else
+                {
+                    return true;
+                }
+            }
+
+            ////////////////////////////////////////////////////////
+            // Reads arg "I" from the buffer, returning it by value
+            // (so it's materialized directly in the parameter of
+            // the target function, or in a temporary bound to it
+            // if the parameter is a reference)
+            ////////////////////////////////////////////////////////
+            template <std::size_t I>
+            static DecayedArg_t<I> DecodeArg(const std::byte *bytes) noexcept
+            {
+                using T = DecayedArg_t<I>;
+                if constexpr (IsMarshalBlob_v<T>)
+                {
+                    using Element_t = typename MarshalBlobTraits<T>::Element_t;
+
+                    MarshalBlobRef blobRef;
+                    std::memcpy(&blobRef, bytes + Offsets[I], sizeof(blobRef));
+
+                    return MarshalBlobTraits<T>::Make(reinterpret_cast<const Element_t *>(bytes + blobRef.m_Offset), blobRef.m_Count);
+                }
+                else
+                {
+                    ///////////////////////////////////////////////////
+                    // Copy into properly aligned storage. Compilers
+                    // optimize this into a plain load.
+                    ///////////////////////////////////////////////////
+                    alignas(T) std::byte storage[sizeof(T)];
+                    std::memcpy(storage, bytes + Offsets[I], sizeof(T));
+                    return *std::launder(reinterpret_cast<const T *>(storage));
+                }
+            }
+
+            template <std::size_t... I,
+                      typename CallableT,
+                      typename... LeadingArgsT>
+            static decltype(auto) DecodeAndInvokeImpl([[maybe_unused]] const std::byte *bytes,
+                                                      std::index_sequence<I...>,
+                                                      CallableT&& f,
+                                                      LeadingArgsT&&... leadingArgs)
+            {
+                return std::invoke(std::forward<CallableT>(f),
+                                   std::forward<LeadingArgsT>(leadingArgs)...,
+                                   DecodeArg<I>(bytes)...);
+            }
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Marshal. Encodes the args of a call to "F" into a flat byte buffer and
+    // decodes them into a call. See top of this file for details. "F" can be
+    // any function type supported by "FunctionTraits" (only its arg types are
+    // used). Its static members are:
+    //
+    //   FixedSize_v       - Size of the fixed section (in bytes)
+    //   Alignment_v       - Required alignment of buffers passed to
+    //                       "DecodeAndInvoke()"
+    //   EncodedSize()     - Number of bytes required to encode the given args
+    //   Encode()          - Encodes the given args into a buffer
+    //   Validate()        - Checks that a (received) buffer is well-formed
+    //   DecodeAndInvoke() - Decodes a buffer and invokes a callable with its
+    //                       args
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class Marshal : public Private::MarshalImpl<ArgTypes_t<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(!IsVariadic_v<F>, "Variadic functions aren't supported by \"Marshal\"");
+
+    public:
+        Marshal() = delete;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef MARSHAL (#include guard)
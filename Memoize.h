@@ -0,0 +1,428 @@
+#ifndef MEMOIZE
+#define MEMOIZE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Memoize", a thread-safe wrapper
+// around any free function or functor that caches its results, intended
+// for expensive pure functions (lookups, parsing, conversions, etc.):
+//
+//     int ComputeCost(int from, int to, Mode mode);
+//
+//     Memoize memoizedCost(&ComputeCost); // Capacity of 1024 results by default
+//     const int cost = memoizedCost(1, 2, Mode::Fast); // Computed
+//     const int sameCost = memoizedCost(1, 2, Mode::Fast); // Cached
+//
+// The function's arg types and return type are obtained via
+// "FunctionTraits" (see "FunctionTraits.h"). The (decayed) args are packed
+// contiguously (without padding) into a fixed-size byte array that serves
+// as the cache key, so it's hashed (FNV-1a) and compared as raw bytes,
+// with no per-type hash or equality functions and no allocations. Each
+// decayed arg type must therefore be trivially copyable with a unique
+// object representation (no padding bits, so equal values have equal
+// bytes) or a floating point type (where +0.0 and -0.0 are treated as
+// different keys, which merely costs a cache miss). Note that pointer
+// args are keyed by address, not by what they point to. Functions whose
+// args don't qualify (such as "std::string"), that return "void" or a
+// reference, or that are non-static member functions or variadic are
+// rejected at compile time.
+//
+// Results are stored in a bounded cache split into shards (16 by
+// default), each guarded by its own mutex (lock striping) so threads
+// looking up different keys rarely contend. Each shard is a set
+// associative table (8 entries per set) allocated once on construction,
+// using the CLOCK (second chance) algorithm within each set to evict
+// entries when it's full, an approximation of LRU that's cheap to
+// maintain on lookups. The function itself is invoked outside of any
+// lock so a slow computation never blocks other threads (two threads
+// missing on the same key concurrently may therefore both compute it).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <optional>
+    #include <string_view>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        //////////////////////////////////////////////////////////
+        // Is "T" (a decayed arg type) usable as part of a raw
+        // byte key (see top of this file)
+        //////////////////////////////////////////////////////////
+        template <typename T>
+        inline constexpr bool IsMemoizeKeyType_v = std::is_trivially_copyable_v<T> &&
+                                                   (std::has_unique_object_representations_v<T> ||
+                                                    std::is_floating_point_v<T>);
+
+        template <typename T>
+        inline constexpr bool IsMemoizeResultType_v = !std::is_void_v<T> &&
+                                                      !std::is_reference_v<T> &&
+                                                      std::is_copy_constructible_v<T>;
+
+        inline constexpr std::size_t MemoizeWays = 8;
+
+        //////////////////////////////////////////////////////////
+        // Rounds "value" up to the next power of 2
+        //////////////////////////////////////////////////////////
+        constexpr std::size_t RoundUpToPowerOf2(std::size_t value) noexcept
+        {
+            std::size_t powerOf2 = 1;
+            while (powerOf2 < value)
+            {
+                powerOf2 <<= 1;
+            }
+
+            return powerOf2;
+        }
+
+        template <typename TupleT>
+        class MemoizeImpl;
+
+        template <typename... ArgsT>
+        class MemoizeImpl<std::tuple<ArgsT...>>
+        {
+        public:
+            //////////////////////////////////////////////////////
+            // Size of the key (sum of the sizes of all decayed
+            // args, packed without padding)
+            //////////////////////////////////////////////////////
+            static constexpr std::size_t KeySize_v = (std::size_t(0) + ... + sizeof(std::decay_t<ArgsT>));
+
+            static_assert((IsMemoizeKeyType_v<std::decay_t<ArgsT>> && ...),
+                          "Memoized functions must take args whose decayed types are trivially copyable "
+                          "with a unique object representation (or are floating point types). See top of "
+                          "\"Memoize.h\" for details.");
+
+            // At least one byte so the key is a valid (non-empty) array
+            using Key = std::array<unsigned char, KeySize_v == 0 ? 1 : KeySize_v>;
+
+            static Key MakeKey(const std::decay_t<ArgsT>&... args) noexcept
+            {
+                Key key{};
+                [[maybe_unused]] std::size_t offset = 0;
+                ((std::memcpy(key.data() + offset, std::addressof(args), sizeof(args)), offset += sizeof(args)), ...);
+                return key;
+            }
+
+            static std::uint64_t Hash(const Key& key) noexcept
+            {
+                std::uint64_t hash = 14695981039346656037ull;
+                for (const unsigned char byte : key)
+                {
+                    hash ^= byte;
+                    hash *= 1099511628211ull;
+                }
+
+                ///////////////////////////////////////////////
+                // Final avalanche (so both the low bits, which
+                // select the set, and the high bits, which
+                // select the shard, are well distributed)
+                ///////////////////////////////////////////////
+                hash ^= hash >> 33;
+                hash *= 0xFF51AFD7ED558CCDull;
+                hash ^= hash >> 33;
+
+                return hash;
+            }
+        };
+
+        //////////////////////////////////////////////////////////
+        // Bounded set associative cache of "ValueT" keyed by
+        // "KeyT" (a byte array), using CLOCK eviction within
+        // each set. Not thread safe (each "Memoize" shard wraps
+        // one of these with its own mutex).
+        //////////////////////////////////////////////////////////
+        template <typename KeyT, typename ValueT>
+        class MemoizeShard
+        {
+        public:
+            explicit MemoizeShard(std::size_t setCount)
+                : m_Slots(setCount * MemoizeWays),
+                  m_Hands(setCount),
+                  m_SetMask(setCount - 1)
+            {
+            }
+
+            const ValueT* Find(std::uint64_t hash, const KeyT& key) noexcept
+            {
+                Slot *const set = GetSet(hash);
+                for (std::size_t way = 0; way < MemoizeWays; ++way)
+                {
+                    Slot& slot = set[way];
+                    if (slot.m_Value && slot.m_Hash == hash && slot.m_Key == key)
+                    {
+                        slot.m_Referenced = true;
+                        return &*slot.m_Value;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            void Insert(std::uint64_t hash, const KeyT& key, const ValueT& value)
+            {
+                Slot *const set = GetSet(hash);
+
+                ///////////////////////////////////////////////
+                // Already present (inserted by another thread
+                // that missed on the same key concurrently)?
+                // Keep the existing value.
+                ///////////////////////////////////////////////
+                for (std::size_t way = 0; way < MemoizeWays; ++way)
+                {
+                    if (!set[way].m_Value)
+                    {
+                        Store(set[way], hash, key, value);
+                        return;
+                    }
+
+                    if (set[way].m_Hash == hash && set[way].m_Key == key)
+                    {
+                        return;
+                    }
+                }
+
+                ///////////////////////////////////////////////
+                // Set is full so evict via CLOCK: advance the
+                // set's hand, giving each referenced entry a
+                // second chance, until reaching an entry not
+                // referenced since the hand last passed it
+                ///////////////////////////////////////////////
+                unsigned char& hand = m_Hands[static_cast<std::size_t>(hash) & m_SetMask];
+                while (set[hand].m_Referenced)
+                {
+                    set[hand].m_Referenced = false;
+                    hand = static_cast<unsigned char>((hand + 1) % MemoizeWays);
+                }
+
+                Store(set[hand], hash, key, value);
+                hand = static_cast<unsigned char>((hand + 1) % MemoizeWays);
+            }
+
+            void Clear() noexcept
+            {
+                for (Slot& slot : m_Slots)
+                {
+                    slot.m_Value.reset();
+                    slot.m_Referenced = false;
+                }
+            }
+
+        private:
+            struct Slot
+            {
+                std::uint64_t m_Hash = 0;
+                KeyT m_Key{};
+                bool m_Referenced = false;
+                std::optional<ValueT> m_Value; // Empty if slot unused
+            };
+
+            Slot* GetSet(std::uint64_t hash) noexcept
+            {
+                return m_Slots.data() + (static_cast<std::size_t>(hash) & m_SetMask) * MemoizeWays;
+            }
+
+            static void Store(Slot& slot, std::uint64_t hash, const KeyT& key, const ValueT& value)
+            {
+                slot.m_Value.emplace(value);
+                slot.m_Hash = hash;
+                slot.m_Key = key;
+                slot.m_Referenced = false;
+            }
+
+            std::vector<Slot> m_Slots;
+            std::vector<unsigned char> m_Hands; // CLOCK hand of each set
+            std::size_t m_SetMask;
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Memoize. Caches the results of (typically expensive and pure) function
+    // "F" (any free function or functor type supported by "FunctionTraits",
+    // normally deduced from the constructor's arg). Callable with the same
+    // args as "F" and thread safe. See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class Memoize : private Private::MemoizeImpl<ArgTypes_t<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        static_assert(!std::is_member_function_pointer_v<F>,
+                      "Non-static member functions can't be memoized (wrap the call in a lambda "
+                      "capturing the object if required)");
+        static_assert(!IsVariadic_v<F>, "Variadic functions can't be memoized");
+
+        using Impl = Private::MemoizeImpl<ArgTypes_t<F>>;
+        using Key = typename Impl::Key;
+
+    public:
+        using Result_t = ReturnType_t<F>;
+
+        static_assert(Private::IsMemoizeResultType_v<Result_t>,
+                      "Memoized functions must return a copy constructible, non-reference type (not void)");
+
+        ///////////////////////////////////////////////////////
+        // Caches up to (approximately) "capacity" results
+        // over "shardCount" shards (both rounded up so each
+        // shard has a power of 2 number of sets)
+        ///////////////////////////////////////////////////////
+        explicit Memoize(F function,
+                         std::size_t capacity = 1024,
+                         std::size_t shardCount = 16)
+            : m_Function(std::move(function)),
+              m_ShardMask(Private::RoundUpToPowerOf2(shardCount == 0 ? 1 : shardCount) - 1),
+              m_Shards(std::make_unique<Shard[]>(m_ShardMask + 1))
+        {
+            const std::size_t perShard = (capacity + m_ShardMask) / (m_ShardMask + 1);
+            const std::size_t setCount = Private::RoundUpToPowerOf2((perShard + Private::MemoizeWays - 1) / Private::MemoizeWays);
+
+            for (std::size_t i = 0; i <= m_ShardMask; ++i)
+            {
+                m_Shards[i].m_Cache.emplace(setCount);
+            }
+        }
+
+        Memoize(const Memoize&) = delete;
+        Memoize& operator=(const Memoize&) = delete;
+
+        ///////////////////////////////////////////////////////
+        // Returns the cached result for "args" if present,
+        // otherwise invokes the function and caches its
+        // result (not cached if the function throws)
+        ///////////////////////////////////////////////////////
+        template <typename... ArgsT>
+        Result_t operator()(ArgsT&&... args)
+        {
+            static_assert(sizeof...(ArgsT) == ArgCount_v<F> && std::is_invocable_v<F&, ArgsT&&...>,
+                          "Invalid args for memoized function");
+
+            return Invoke(std::forward<ArgsT>(args)...);
+        }
+
+        /////////////////////////////////////////////////
+        // Removes all cached results (not atomic with
+        // respect to concurrent calls, which may cache
+        // results in shards already cleared)
+        /////////////////////////////////////////////////
+        void Clear() noexcept
+        {
+            for (std::size_t i = 0; i <= m_ShardMask; ++i)
+            {
+                std::lock_guard<std::mutex> lock(m_Shards[i].m_Mutex);
+                m_Shards[i].m_Cache->Clear();
+            }
+        }
+
+    private:
+        ///////////////////////////////////////////////////////
+        // Each shard on its own cache line(s) so threads
+        // locking different shards don't falsely share
+        ///////////////////////////////////////////////////////
+        struct alignas(64) Shard
+        {
+            std::mutex m_Mutex;
+            std::optional<Private::MemoizeShard<Key, Result_t>> m_Cache;
+        };
+
+        template <typename... ArgsT>
+        Result_t Invoke(ArgsT&&... args)
+        {
+            // Convert to the function's (decayed) arg types first so the key matches regardless of how it's called
+            return InvokeWithKey(std::make_index_sequence<sizeof...(ArgsT)>(), std::forward<ArgsT>(args)...);
+        }
+
+        template <std::size_t... I, typename... ArgsT>
+        Result_t InvokeWithKey(std::index_sequence<I...>, ArgsT&&... args)
+        {
+            const Key key = Impl::MakeKey(static_cast<std::decay_t<ArgType_t<F, I>>>(args)...);
+            const std::uint64_t hash = Impl::Hash(key);
+            Shard& shard = m_Shards[static_cast<std::size_t>(hash >> 48) & m_ShardMask];
+
+            {
+                std::lock_guard<std::mutex> lock(shard.m_Mutex);
+                if (const Result_t *const result = shard.m_Cache->Find(hash, key))
+                {
+                    return *result;
+                }
+            }
+
+            // Invoked without holding the lock (see top of this file)
+            Result_t result = std::invoke(m_Function, std::forward<ArgsT>(args)...);
+
+            std::lock_guard<std::mutex> lock(shard.m_Mutex);
+            shard.m_Cache->Insert(hash, key, result);
+
+            return result;
+        }
+
+        F m_Function;
+        std::size_t m_ShardMask;
+        std::unique_ptr<Shard[]> m_Shards;
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Deduction guide so free functions are stored as function
+    // pointers, e.g., "Memoize memoized(ComputeCost)"
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    Memoize(F) -> Memoize<std::decay_t<F>>;
+
+    template <typename F>
+    Memoize(F, std::size_t) -> Memoize<std::decay_t<F>>;
+
+    template <typename F>
+    Memoize(F, std::size_t, std::size_t) -> Memoize<std::decay_t<F>>;
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef MEMOIZE (#include guard)
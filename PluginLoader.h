@@ -0,0 +1,418 @@
+#ifndef PLUGIN_LOADER
+#define PLUGIN_LOADER
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring "AbiFingerprint_v", a compile-time 64 bit
+// fingerprint of a function's ABI, and class "PluginLibrary", which loads a
+// shared library (plugin) and resolves its exported functions, verifying
+// each one's fingerprint against the caller's expected signature with a
+// single integer comparison.
+//
+// The fingerprint is derived via "FunctionTraits" (see "FunctionTraits.h")
+// from everything that affects how a function is called, i.e., its return
+// type and arg types (their names via "TypeName_v", plus the "sizeof" and
+// "alignof" of each, so layout changes to structs passed by value are
+// also detected), calling convention, "noexcept" specification, variadic
+// status, and for non-static member functions, the class and cv and ref
+// qualifiers. Note that the pointees of pointer and reference types only
+// contribute their names (not their layout), since they may be complete
+// in some translation units and only forward declared in others (e.g., a
+// host passing an opaque handle to a plugin that defines it), and the
+// fingerprint must be the same in all of them.
+//
+// Plugins export each function along with a companion fingerprint symbol
+// via STDEXT_EXPORT_PLUGIN_FUNCTION:
+//
+//     // In the plugin (a shared library)
+//     extern "C" STDEXT_PLUGIN_EXPORT int Transform(const Image& image, float scale) noexcept;
+//     STDEXT_EXPORT_PLUGIN_FUNCTION(Transform)
+//
+//     // In the host
+//     PluginLibrary plugin("libtransform.so");
+//     const auto transform = plugin.GetFunction<int (const Image&, float) noexcept>("Transform");
+//
+// "GetFunction()" throws "PluginError" if the function or its fingerprint
+// isn't found or the fingerprints differ (i.e., the plugin was built
+// against a different signature or a different layout of any type
+// involved), while "TryGetFunction()" returns a "PluginStatus" instead.
+// Resolved functions are cached, so subsequent requests for the same
+// function don't even need to look up its symbol.
+//
+// Note that since the fingerprint is based on "TypeName_v", which is
+// compiler-specific, the host and its plugins should be built with the
+// same compiler (which is normally required for C++ plugins anyway).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <cstddef>
+    #include <cstdint>
+    #include <mutex>
+    #include <stdexcept>
+    #include <string>
+    #include <string_view>
+    #include <type_traits>
+    #include <unordered_map>
+    #include <utility>
+#endif
+
+#if defined(_WIN32)
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    // POSIX headers
+    #include <dlfcn.h>
+#endif
+
+////////////////////////////////////////////////////////////////////
+// STDEXT_PLUGIN_EXPORT. Exports a symbol from a shared library
+// (apply to each plugin function)
+////////////////////////////////////////////////////////////////////
+#if defined(_WIN32)
+    #define STDEXT_PLUGIN_EXPORT __declspec(dllexport)
+#else
+    #define STDEXT_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+////////////////////////////////////////////////////////////////////
+// Suffix appended to the name of each exported plugin function to
+// form the name of its companion fingerprint symbol
+////////////////////////////////////////////////////////////////////
+#define STDEXT_PLUGIN_FINGERPRINT_SUFFIX "_StdExtAbiFingerprint"
+
+////////////////////////////////////////////////////////////////////
+// STDEXT_EXPORT_PLUGIN_FUNCTION. Exports the ABI fingerprint of
+// plugin function FUNCTION (which must itself be exported as
+// "extern "C"" so its symbol name is just its name), as symbol
+// FUNCTION_StdExtAbiFingerprint (see STDEXT_PLUGIN_FINGERPRINT_SUFFIX
+// above). Use at namespace scope in the plugin, after FUNCTION is
+// declared.
+////////////////////////////////////////////////////////////////////
+#define STDEXT_EXPORT_PLUGIN_FUNCTION(FUNCTION) \
+    extern "C" STDEXT_PLUGIN_EXPORT const std::uint64_t FUNCTION##_StdExtAbiFingerprint = StdExt::AbiFingerprint_v<decltype(FUNCTION)>;
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Continues FNV-1a hash "hash" with the bytes of "value"
+        // (least significant first so the result is independent
+        // of byte order)
+        ////////////////////////////////////////////////////////////
+        constexpr std::uint64_t Fnv1aHashValue(std::uint64_t value, std::uint64_t hash) noexcept
+        {
+            for (std::size_t i = 0; i < sizeof(value); ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        template <typename T,
+                  typename = void>
+        struct IsCompleteType : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct IsCompleteType<T, std::void_t<decltype(sizeof(T))>> : std::true_type
+        {
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Continues "hash" with the size and alignment of "T" if
+        // it's an object type (which must be complete so the
+        // fingerprint is the same in every translation unit).
+        // Pointees of pointer and reference types are ignored
+        // (see top of file).
+        ////////////////////////////////////////////////////////////
+        template <typename T>
+        constexpr std::uint64_t HashTypeLayout(std::uint64_t hash) noexcept
+        {
+            if constexpr (std::is_object_v<T>)
+            {
+                static_assert(IsCompleteType<T>::value,
+                              "Types passed or returned by value must be complete to compute \"AbiFingerprint_v\"");
+
+                hash = Fnv1aHashValue(sizeof(T), hash);
+                hash = Fnv1aHashValue(alignof(T), hash);
+            }
+
+            return hash;
+        }
+
+        template <typename T>
+        constexpr std::uint64_t HashAbiType(std::uint64_t hash) noexcept
+        {
+            return HashTypeLayout<T>(Fnv1aHash(TypeName_v<T>, hash));
+        }
+
+        template <typename F,
+                  std::size_t... I>
+        constexpr std::uint64_t HashAbiArgs(std::uint64_t hash, std::index_sequence<I...>) noexcept
+        {
+            ((hash = HashAbiType<ArgType_t<F, I>>(hash)), ...);
+            return hash;
+        }
+
+        template <TRAITS_FUNCTION_C F>
+        constexpr std::uint64_t GetAbiFingerprint() noexcept
+        {
+            std::uint64_t hash = Fnv1aHash(std::string_view("StdExt::AbiFingerprint"));
+
+            hash = HashAbiType<ReturnType_t<F>>(hash);
+            hash = Fnv1aHashValue(ArgCount_v<F>, hash);
+            hash = HashAbiArgs<F>(hash, std::make_index_sequence<ArgCount_v<F>>());
+            hash = Fnv1aHashValue(static_cast<std::uint64_t>(CallingConvention_v<F>), hash);
+            hash = Fnv1aHashValue(IsNoexcept_v<F>, hash);
+            hash = Fnv1aHashValue(IsVariadic_v<F>, hash);
+
+            if constexpr (FunctionClassification_v<F> == FunctionClassification::NonStaticMember)
+            {
+                hash = HashAbiType<MemberFunctionClass_t<F>>(hash);
+                hash = Fnv1aHashValue(IsFunctionConst_v<F>, hash);
+                hash = Fnv1aHashValue(IsFunctionVolatile_v<F>, hash);
+                hash = Fnv1aHashValue(static_cast<std::uint64_t>(FunctionReference_v<F>), hash);
+            }
+
+            return hash;
+        }
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // AbiFingerprint_v. Compile-time 64 bit fingerprint of the ABI of "F" (any
+    // function type supported by "FunctionTraits"). See top of this file for
+    // details. Pointers and references to the same function type have the
+    // same fingerprint.
+    ///////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    inline constexpr std::uint64_t AbiFingerprint_v = Private::GetAbiFingerprint<F>();
+
+    /////////////////////////////////////////////////////////////////////////
+    // PluginStatus. Result of "PluginLibrary::TryGetFunction()"
+    /////////////////////////////////////////////////////////////////////////
+    enum class PluginStatus
+    {
+        Ok,
+        LibraryNotLoaded,    // The plugin itself couldn't be loaded (reported by "PluginLibrary"'s constructor only)
+        FunctionNotFound,    // The function isn't exported by the plugin
+        FingerprintNotFound, // The function is exported but not its fingerprint (see STDEXT_EXPORT_PLUGIN_FUNCTION)
+        FingerprintMismatch  // The plugin's function has a different ABI than the one requested
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // PluginError. Exception thrown by "PluginLibrary" on failure
+    /////////////////////////////////////////////////////////////////////////
+    class PluginError : public std::runtime_error
+    {
+    public:
+        PluginError(PluginStatus status, const std::string& message)
+            : std::runtime_error(message),
+              m_Status(status)
+        {
+        }
+
+        PluginStatus GetStatus() const noexcept
+        {
+            return m_Status;
+        }
+
+    private:
+        PluginStatus m_Status;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // PluginLibrary. Loads a plugin (shared library) and resolves its
+    // functions, verifying their ABI fingerprints (see top of this file).
+    // Thread safe. Functions returned remain valid for the life of the
+    // "PluginLibrary" object (the library is unloaded on destruction).
+    /////////////////////////////////////////////////////////////////////////////
+    class PluginLibrary
+    {
+    public:
+        ////////////////////////////////////////////////////////
+        // Loads the plugin at "path" (throws "PluginError" on
+        // failure, with status "PluginStatus::LibraryNotLoaded")
+        ////////////////////////////////////////////////////////
+        explicit PluginLibrary(const std::string& path)
+        {
+            #if defined(_WIN32)
+                m_Handle = ::LoadLibraryA(path.c_str());
+                if (!m_Handle)
+                {
+                    throw PluginError(PluginStatus::LibraryNotLoaded,
+                                      "Unable to load plugin \"" + path + "\" (error " + std::to_string(::GetLastError()) + ")");
+                }
+            #else
+                m_Handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+                if (!m_Handle)
+                {
+                    const char *const error = ::dlerror();
+                    throw PluginError(PluginStatus::LibraryNotLoaded,
+                                      "Unable to load plugin \"" + path + "\": " + (error ? error : "unknown error"));
+                }
+            #endif
+        }
+
+        PluginLibrary(const PluginLibrary&) = delete;
+        PluginLibrary& operator=(const PluginLibrary&) = delete;
+
+        ~PluginLibrary()
+        {
+            #if defined(_WIN32)
+                ::FreeLibrary(m_Handle);
+            #else
+                ::dlclose(m_Handle);
+            #endif
+        }
+
+        ////////////////////////////////////////////////////////
+        // Resolves exported function "name" whose expected
+        // type is "F" (a free function type, or pointer or
+        // reference to one), storing it in "function" if its
+        // fingerprint matches "AbiFingerprint_v<F>" (otherwise
+        // "function" is set to null). Returns the status.
+        ////////////////////////////////////////////////////////
+        template <TRAITS_FREE_FUNCTION_C F>
+        PluginStatus TryGetFunction(const std::string& name, std::add_pointer_t<FunctionRawType_t<F>>& function)
+        {
+            /////////////////////////////////////////////////////////
+            // Kicks in if concepts not supported, otherwise the
+            // following resolves to whitespace and the
+            // corresponding concept kicks in in the template
+            // declaration above instead
+            /////////////////////////////////////////////////////////
+            STATIC_ASSERT_IS_TRAITS_FREE_FUNCTION(F)
+
+            using FunctionPointerT = std::add_pointer_t<FunctionRawType_t<F>>;
+
+            void *address = nullptr;
+            const PluginStatus status = Resolve(name, AbiFingerprint_v<F>, address);
+            function = status == PluginStatus::Ok ? reinterpret_cast<FunctionPointerT>(address) : nullptr;
+
+            return status;
+        }
+
+        ////////////////////////////////////////////////////////
+        // Same as "TryGetFunction()" but returns the function
+        // and throws "PluginError" on failure
+        ////////////////////////////////////////////////////////
+        template <TRAITS_FREE_FUNCTION_C F>
+        std::add_pointer_t<FunctionRawType_t<F>> GetFunction(const std::string& name)
+        {
+            std::add_pointer_t<FunctionRawType_t<F>> function;
+            switch (TryGetFunction<F>(name, function))
+            {
+                case PluginStatus::Ok:
+                    return function;
+                case PluginStatus::FunctionNotFound:
+                    throw PluginError(PluginStatus::FunctionNotFound, "Plugin function \"" + name + "\" not found");
+                case PluginStatus::FingerprintNotFound:
+                    throw PluginError(PluginStatus::FingerprintNotFound, "Plugin function \"" + name + "\" has no ABI fingerprint");
+                case PluginStatus::FingerprintMismatch:
+                default:
+                    throw PluginError(PluginStatus::FingerprintMismatch, "Plugin function \"" + name + "\" has an incompatible ABI");
+            }
+        }
+
+    private:
+        ////////////////////////////////////////////////////////
+        // Cached result of resolving a function (its address
+        // and the fingerprint exported for it)
+        ////////////////////////////////////////////////////////
+        struct ResolvedFunction
+        {
+            void *m_Address;
+            std::uint64_t m_Fingerprint;
+        };
+
+        PluginStatus Resolve(const std::string& name, std::uint64_t fingerprint, void *& address)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Cache.find(name);
+            if (it == m_Cache.end())
+            {
+                void *const functionAddress = GetSymbol(name.c_str());
+                if (!functionAddress)
+                {
+                    return PluginStatus::FunctionNotFound;
+                }
+
+                const void *const fingerprintAddress = GetSymbol((name + STDEXT_PLUGIN_FINGERPRINT_SUFFIX).c_str());
+                if (!fingerprintAddress)
+                {
+                    return PluginStatus::FingerprintNotFound;
+                }
+
+                const ResolvedFunction resolvedFunction = {functionAddress, *static_cast<const std::uint64_t *>(fingerprintAddress)};
+                it = m_Cache.emplace(name, resolvedFunction).first;
+            }
+
+            if (it->second.m_Fingerprint != fingerprint)
+            {
+                return PluginStatus::FingerprintMismatch;
+            }
+
+            address = it->second.m_Address;
+            return PluginStatus::Ok;
+        }
+
+        void *GetSymbol(const char *name) const noexcept
+        {
+            #if defined(_WIN32)
+                return reinterpret_cast<void *>(::GetProcAddress(m_Handle, name));
+            #else
+                return ::dlsym(m_Handle, name);
+            #endif
+        }
+
+        #if defined(_WIN32)
+            HMODULE m_Handle;
+        #else
+            void *m_Handle;
+        #endif
+
+        std::mutex m_Mutex;
+        std::unordered_map<std::string, ResolvedFunction> m_Cache;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef PLUGIN_LOADER (#include guard)
@@ -0,0 +1,1165 @@
+#ifndef RPC
+#define RPC
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring a small (loopback) RPC library whose client stubs
+// and server dispatch table are generated at compile time from a list of
+// functions, using "FunctionTraits" (see "FunctionTraits.h") to obtain
+// their signatures, and "Marshal" (see "Marshal.h") to encode the args.
+// No hand-written stubs or serialization code are required:
+//
+//     int Add(int, int);
+//     void Log(std::string_view message);
+//     class Counter
+//     {
+//     public:
+//         std::uint64_t Increment(std::uint64_t delta);
+//     };
+//
+//     // Shared by client and server
+//     using MyInterface = RpcInterface<&Add, &Log, &Counter::Increment>;
+//
+//     // Server (typically in another thread or process)
+//     Counter counter;
+//     RpcServer<MyInterface> server;
+//     server.BindObject(&counter); // For "Counter::Increment"
+//     RpcUnixSocketListener listener("/tmp/my.sock");
+//     listener.Serve(server);
+//
+//     // Client
+//     RpcUnixSocketClient transport("/tmp/my.sock");
+//     RpcClient<MyInterface, RpcUnixSocketClient> client(transport);
+//     const int sum = client.Call<&Add>(1, 2);
+//     client.Call<&Log>("Hello");
+//
+// 1) Requests consist of a fixed header (the method ID and a call ID)
+//    followed by the args of the call encoded via "Marshal" (so the
+//    layout is determined by "ArgTypes_t" of each function, and args are
+//    subject to the same restrictions as "Marshal").
+// 2) Responses consist of a fixed header (the call ID and an
+//    "RpcStatus") followed by the return value of the call (determined by
+//    "ReturnType_t", which must be "void", trivially copyable, or a
+//    "std::basic_string"), or the exception message if the call threw.
+// 3) Method IDs are a (64 bit) hash of each function's signature (its
+//    "TypeNameHash_v") combined with its position in the "RpcInterface".
+//    Duplicate IDs are detected at compile time.
+//
+// Transports are pluggable. Clients require a transport with the
+// following member (which must throw "RpcError" on failure):
+//
+//     void Transact(const std::vector<std::byte>& request, std::vector<std::byte>& response);
+//
+// while servers are simply passed each request via "RpcServer::Dispatch()"
+// (by whatever means the transport receives them). Two reference
+// transports are provided, "RpcQueueTransport" (an in-process queue
+// serviced by a server thread) and on POSIX platforms,
+// "RpcUnixSocketClient" and "RpcUnixSocketListener" (Unix domain sockets).
+// Note that as per "Marshal", the wire format is native (byte order and
+// type layouts) so it's intended for communication on the same machine
+// only.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// "Marshal.h" #includes "FunctionTraits.h" which #includes
+// "CompilerVersions.h" so all C++ version constants such as
+// CPP17_OR_LATER (tested just below) are available after the
+// following
+/////////////////////////////////////////////////////////////////////
+#include "Marshal.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+////////////////////////////////////////////////////////////////
+// Unix domain socket transport only available on POSIX
+// platforms (for internal use only - we #undef it later)
+////////////////////////////////////////////////////////////////
+#if defined(__unix__) || defined(__APPLE__)
+    #define RPC_UNIX_SOCKETS_SUPPORTED
+#endif
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <deque>
+    #include <exception>
+    #include <functional>
+    #include <mutex>
+    #include <stdexcept>
+    #include <string>
+    #include <string_view>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+#if defined(RPC_UNIX_SOCKETS_SUPPORTED)
+    // POSIX headers
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace StdExt
+{
+    /////////////////////////////////////////////////////////////////////////
+    // RpcStatus. Status of an RPC call as reported in each response (and
+    // by "RpcError" on failure).
+    /////////////////////////////////////////////////////////////////////////
+    enum class RpcStatus : std::uint32_t
+    {
+        Ok,
+        UnknownMethod,  // Method ID not found in the server's interface
+        BadRequest,     // Malformed request (failed validation)
+        UnboundObject,  // Member function called but no object bound (see "RpcServer::BindObject()")
+        Exception,      // The function threw (message is returned in the response)
+        TransportError, // Request couldn't be sent or response received
+        BadResponse     // Malformed response
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // RpcError. Exception thrown by "RpcClient" (and transports) when a
+    // call fails.
+    /////////////////////////////////////////////////////////////////////////
+    class RpcError : public std::runtime_error
+    {
+    public:
+        RpcError(RpcStatus status, const std::string& message)
+            : std::runtime_error(message),
+              m_Status(status)
+        {
+        }
+
+        RpcStatus GetStatus() const noexcept
+        {
+            return m_Status;
+        }
+
+    private:
+        RpcStatus m_Status;
+    };
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Headers preceding the marshalled args of each request
+        // and the return value of each response. 16 bytes each so
+        // whatever follows is suitably aligned for "Marshal" (when
+        // the buffer itself is allocated via "operator new")
+        ////////////////////////////////////////////////////////////
+        struct RpcRequestHeader
+        {
+            std::uint64_t m_MethodId;
+            std::uint64_t m_CallId;
+        };
+
+        struct RpcResponseHeader
+        {
+            std::uint64_t m_CallId;
+            RpcStatus m_Status;
+            std::uint32_t m_Reserved;
+        };
+
+        static_assert(sizeof(RpcRequestHeader) == 16 && sizeof(RpcResponseHeader) == 16);
+
+        ////////////////////////////////////////////////////////////
+        // Returns the ID of the method at index "index" of an
+        // "RpcInterface" whose signature hash is "signatureHash"
+        // (continues the FNV-1a hash with the bytes of "index")
+        ////////////////////////////////////////////////////////////
+        constexpr std::uint64_t GetRpcMethodId(std::uint64_t signatureHash, std::size_t index) noexcept
+        {
+            std::uint64_t hash = signatureHash;
+            for (std::size_t i = 0; i < sizeof(index); ++i)
+            {
+                hash ^= static_cast<std::uint64_t>((index >> (i * 8)) & 0xFF);
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // RpcReturn. Encodes and decodes return values of type
+        // "R" (the payload of a successful response).
+        // "std::basic_string" return values are marshalled as
+        // their "std::basic_string_view" (and copied back into a
+        // "std::basic_string" by the client), all others as is
+        // (and must therefore be trivially copyable).
+        ////////////////////////////////////////////////////////////
+        template <typename R>
+        struct RpcReturn
+        {
+            using Wire_t = R;
+
+            static_assert(std::is_trivially_copyable_v<R> && !std::is_pointer_v<R> && !std::is_reference_v<R>,
+                          "The return type of functions in an \"RpcInterface\" must be \"void\", trivially "
+                          "copyable (but not a pointer or reference), or a \"std::basic_string\"");
+
+            static R FromWire(const Wire_t& value)
+            {
+                return value;
+            }
+        };
+
+        template <typename CharT,
+                  typename TraitsT,
+                  typename AllocatorT>
+        struct RpcReturn<std::basic_string<CharT, TraitsT, AllocatorT>>
+        {
+            using Wire_t = std::basic_string_view<CharT, TraitsT>;
+
+            static std::basic_string<CharT, TraitsT, AllocatorT> FromWire(const Wire_t& value)
+            {
+                return std::basic_string<CharT, TraitsT, AllocatorT>(value);
+            }
+        };
+
+        template <typename R>
+        using RpcReturnMarshal = Marshal<void (typename RpcReturn<R>::Wire_t)>;
+
+        inline void WriteRpcResponseHeader(std::vector<std::byte>& response, std::uint64_t callId, RpcStatus status, std::size_t payloadSize)
+        {
+            response.resize(sizeof(RpcResponseHeader) + payloadSize);
+
+            const RpcResponseHeader header = {callId, status, 0};
+            std::memcpy(response.data(), &header, sizeof(header));
+        }
+
+        inline void WriteRpcErrorResponse(std::vector<std::byte>& response, std::uint64_t callId, RpcStatus status, std::string_view message)
+        {
+            using MessageMarshal = Marshal<void (std::string_view)>;
+
+            const std::size_t payloadSize = MessageMarshal::EncodedSize(message);
+            WriteRpcResponseHeader(response, callId, status, payloadSize);
+            MessageMarshal::Encode(response.data() + sizeof(RpcResponseHeader), payloadSize, message);
+        }
+    } // namespace Private
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // True if "Function1T" and "Function2T" are the same
+        // function (of the same type)
+        ////////////////////////////////////////////////////////////
+        template <auto Function1T,
+                  auto Function2T>
+        constexpr bool IsSameRpcFunction() noexcept
+        {
+            if constexpr (std::is_same_v<decltype(Function1T), decltype(Function2T)>)
+            {
+                return Function1T == Function2T;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Index of "FunctionT" in "FunctionsT", or
+        // "sizeof...(FunctionsT)" if not found
+        ////////////////////////////////////////////////////////////
+        template <auto FunctionT,
+                  auto... FunctionsT>
+        constexpr std::size_t GetRpcFunctionIndex() noexcept
+        {
+            constexpr bool matches[] = {IsSameRpcFunction<FunctionT, FunctionsT>()..., false};
+
+            for (std::size_t i = 0; i < sizeof...(FunctionsT); ++i)
+            {
+                if (matches[i])
+                {
+                    return i;
+                }
+            }
+
+            return sizeof...(FunctionsT);
+        }
+
+        template <auto FunctionT,
+                  auto... FunctionsT>
+        constexpr std::size_t GetRpcFunctionCount() noexcept
+        {
+            return (std::size_t{0} + ... + (IsSameRpcFunction<FunctionT, FunctionsT>() ? 1 : 0));
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Method ID paired with the index of its function in an
+        // "RpcInterface"
+        ////////////////////////////////////////////////////////////
+        struct RpcMethodEntry
+        {
+            std::uint64_t m_Id;
+            std::size_t m_Index;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Returns the method entries of "FunctionsT" sorted by
+        // method ID (for the server's binary search)
+        ////////////////////////////////////////////////////////////
+        template <auto... FunctionsT,
+                  std::size_t... I>
+        constexpr std::array<RpcMethodEntry, sizeof...(FunctionsT)> GetSortedRpcMethods(std::index_sequence<I...>) noexcept
+        {
+            constexpr std::size_t methodCount = sizeof...(FunctionsT);
+            std::array<RpcMethodEntry, methodCount> methods = {RpcMethodEntry{GetRpcMethodId(TypeNameHash_v<decltype(FunctionsT)>, I), I}...};
+
+            // Insertion sort (constexpr and the number of methods is small)
+            for (std::size_t i = 1; i < methodCount; ++i)
+            {
+                const RpcMethodEntry method = methods[i];
+
+                std::size_t j = i;
+                for (; j > 0 && methods[j - 1].m_Id > method.m_Id; --j)
+                {
+                    methods[j] = methods[j - 1];
+                }
+                methods[j] = method;
+            }
+
+            return methods;
+        }
+
+        template <std::size_t N>
+        constexpr bool HasUniqueRpcMethodIds(const std::array<RpcMethodEntry, N>& sortedMethods) noexcept
+        {
+            for (std::size_t i = 1; i < N; ++i)
+            {
+                if (sortedMethods[i].m_Id == sortedMethods[i - 1].m_Id)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcInterface. List of functions (free functions, including static member
+    // functions, or non-static member functions) callable through "RpcClient"
+    // and dispatched by "RpcServer". Pass the same "RpcInterface" to both
+    // (normally via a shared alias). See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <auto... FunctionsT>
+    class RpcInterface
+    {
+        static_assert(((std::is_member_function_pointer_v<decltype(FunctionsT)> ||
+                        IsTraitsFreeFunction_v<std::remove_pointer_t<decltype(FunctionsT)>>) && ...),
+                      "Each function in an \"RpcInterface\" must be a pointer to a free function "
+                      "(including static member functions) or a non-static member function pointer");
+
+        static_assert(((Private::GetRpcFunctionCount<FunctionsT, FunctionsT...>() == 1) && ...),
+                      "Duplicate function in \"RpcInterface\"");
+
+    public:
+        static constexpr std::size_t MethodCount_v = sizeof...(FunctionsT);
+
+        template <std::size_t I>
+        static constexpr auto Function_v = std::get<I>(std::make_tuple(FunctionsT...));
+
+        template <std::size_t I>
+        using Function_t = std::remove_const_t<decltype(Function_v<I>)>;
+
+        template <std::size_t I>
+        static constexpr std::uint64_t MethodIdAt_v = Private::GetRpcMethodId(TypeNameHash_v<Function_t<I>>, I);
+
+        ///////////////////////////////////////////////////////
+        // Index of "FunctionT" in this interface, or
+        // "MethodCount_v" if not found
+        ///////////////////////////////////////////////////////
+        template <auto FunctionT>
+        static constexpr std::size_t IndexOf_v = Private::GetRpcFunctionIndex<FunctionT, FunctionsT...>();
+
+        template <auto FunctionT>
+        static constexpr bool Contains_v = IndexOf_v<FunctionT> != MethodCount_v;
+
+        template <auto FunctionT>
+        static constexpr std::uint64_t MethodId_v = MethodIdAt_v<IndexOf_v<FunctionT>>;
+
+        ///////////////////////////////////////////////////////
+        // Method IDs sorted in ascending order, each paired
+        // with the index of its function
+        ///////////////////////////////////////////////////////
+        static constexpr std::array<Private::RpcMethodEntry, MethodCount_v> SortedMethods =
+            Private::GetSortedRpcMethods<FunctionsT...>(std::make_index_sequence<MethodCount_v>());
+
+        static_assert(Private::HasUniqueRpcMethodIds(SortedMethods),
+                      "Method ID collision in \"RpcInterface\" (two functions hash to the same ID). "
+                      "Reorder the functions to resolve it.");
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcServer. Dispatches requests for the functions in "InterfaceT" (an
+    // "RpcInterface"). The dispatch table (sorted by method ID) is generated
+    // at compile time. Non-static member functions in the interface require
+    // an object, bound via "BindObject()" (a call to a member function whose
+    // object isn't bound fails with "RpcStatus::UnboundObject"). "Dispatch()"
+    // is "const" and may be called concurrently from multiple threads
+    // (provided the functions themselves are thread safe), but objects must
+    // be bound before dispatching begins.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename InterfaceT>
+    class RpcServer
+    {
+        static constexpr std::size_t MethodCount = InterfaceT::MethodCount_v;
+
+        using Thunk_t = void (*)(void *object,
+                                 std::uint64_t callId,
+                                 const std::byte *args,
+                                 std::size_t argsSize,
+                                 std::vector<std::byte>& response);
+
+    public:
+        ////////////////////////////////////////////////////////
+        // Binds "object" to every non-static member function
+        // in the interface whose class is "ClassT" or a base
+        // class of it. The object must outlive the server (or
+        // remain bound only while the server is in use).
+        ////////////////////////////////////////////////////////
+        template <typename ClassT>
+        void BindObject(ClassT *object) noexcept
+        {
+            BindObjectImpl(object, std::make_index_sequence<MethodCount>());
+        }
+
+        ////////////////////////////////////////////////////////
+        // Processes the request in "request" ("size" bytes,
+        // normally received by a transport) and stores the
+        // response in "response" (replacing its contents).
+        // Never throws for malformed requests (an error
+        // response is returned instead), though memory
+        // allocation failures when growing "response" are
+        // propagated.
+        ////////////////////////////////////////////////////////
+        void Dispatch(const std::byte *request, std::size_t size, std::vector<std::byte>& response) const
+        {
+            if (size < sizeof(Private::RpcRequestHeader))
+            {
+                Private::WriteRpcErrorResponse(response, 0, RpcStatus::BadRequest, "Request too small");
+                return;
+            }
+
+            Private::RpcRequestHeader header;
+            std::memcpy(&header, request, sizeof(header));
+
+            const auto methodsBegin = InterfaceT::SortedMethods.begin();
+            const auto methodsEnd = InterfaceT::SortedMethods.end();
+            const auto method = std::lower_bound(methodsBegin,
+                                                 methodsEnd,
+                                                 header.m_MethodId,
+                                                 [](const Private::RpcMethodEntry& entry, std::uint64_t id)
+                                                 {
+                                                     return entry.m_Id < id;
+                                                 });
+
+            if (method == methodsEnd || method->m_Id != header.m_MethodId)
+            {
+                Private::WriteRpcErrorResponse(response, header.m_CallId, RpcStatus::UnknownMethod, "Unknown method ID");
+                return;
+            }
+
+            // Indexed by the function's index in "InterfaceT"
+            static constexpr std::array<Thunk_t, MethodCount> thunks = GetThunks(std::make_index_sequence<MethodCount>());
+
+            const std::size_t index = method->m_Index;
+            thunks[index](m_Objects[index],
+                          header.m_CallId,
+                          request + sizeof(header),
+                          size - sizeof(header),
+                          response);
+        }
+
+    private:
+        template <typename ClassT,
+                  std::size_t... I>
+        void BindObjectImpl(ClassT *object, std::index_sequence<I...>) noexcept
+        {
+            ((BindObjectIfMember<I>(object)), ...);
+        }
+
+        template <std::size_t I,
+                  typename ClassT>
+        void BindObjectIfMember(ClassT *object) noexcept
+        {
+            using F = typename InterfaceT::template Function_t<I>;
+            if constexpr (std::is_member_function_pointer_v<F>)
+            {
+                if constexpr (std::is_base_of_v<MemberFunctionClass_t<F>, ClassT>)
+                {
+                    ////////////////////////////////////////////////////
+                    // Store a pointer to the (base class) object the
+                    // member function will actually be invoked on
+                    // (so any adjustment is applied here, once)
+                    ////////////////////////////////////////////////////
+                    MemberFunctionClass_t<F> *const memberObject = object;
+                    m_Objects[I] = const_cast<void *>(static_cast<const volatile void *>(memberObject));
+                }
+            }
+        }
+
+        template <std::size_t I>
+        static void Thunk([[maybe_unused]] void *object,
+                          std::uint64_t callId,
+                          const std::byte *args,
+                          std::size_t argsSize,
+                          std::vector<std::byte>& response)
+        {
+            constexpr auto function = InterfaceT::template Function_v<I>;
+            using F = typename InterfaceT::template Function_t<I>;
+            using ArgsMarshal = Marshal<F>;
+            using R = ReturnType_t<F>;
+
+            if (!ArgsMarshal::Validate(args, argsSize))
+            {
+                Private::WriteRpcErrorResponse(response, callId, RpcStatus::BadRequest, "Malformed args");
+                return;
+            }
+
+            if constexpr (std::is_member_function_pointer_v<F>)
+            {
+                if (!object)
+                {
+                    Private::WriteRpcErrorResponse(response, callId, RpcStatus::UnboundObject, "No object bound for member function");
+                    return;
+                }
+            }
+
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                {
+                    InvokeFunction<function>(object, args, argsSize);
+                    Private::WriteRpcResponseHeader(response, callId, RpcStatus::Ok, 0);
+                }
+                else
+                {
+                    using ReturnMarshal = Private::RpcReturnMarshal<R>;
+
+                    const R result = InvokeFunction<function>(object, args, argsSize);
+                    const typename Private::RpcReturn<R>::Wire_t& wireResult = result;
+
+                    const std::size_t payloadSize = ReturnMarshal::EncodedSize(wireResult);
+                    Private::WriteRpcResponseHeader(response, callId, RpcStatus::Ok, payloadSize);
+                    ReturnMarshal::Encode(response.data() + sizeof(Private::RpcResponseHeader), payloadSize, wireResult);
+                }
+            }
+            catch (const std::exception& exception)
+            {
+                Private::WriteRpcErrorResponse(response, callId, RpcStatus::Exception, exception.what());
+            }
+            catch (...)
+            {
+                Private::WriteRpcErrorResponse(response, callId, RpcStatus::Exception, "Unknown exception");
+            }
+        }
+
+        template <auto FunctionT>
+        static decltype(auto) InvokeFunction([[maybe_unused]] void *object, const std::byte *args, std::size_t argsSize)
+        {
+            using F = decltype(FunctionT);
+            if constexpr (std::is_member_function_pointer_v<F>)
+            {
+                return Marshal<F>::DecodeAndInvoke(args, argsSize, FunctionT, *static_cast<MemberFunctionClass_t<F> *>(object));
+            }
+            else
+            {
+                return Marshal<F>::DecodeAndInvoke(args, argsSize, FunctionT);
+            }
+        }
+
+        template <std::size_t... I>
+        static constexpr std::array<Thunk_t, MethodCount> GetThunks(std::index_sequence<I...>) noexcept
+        {
+            return {&Thunk<I>...};
+        }
+
+        std::array<void *, MethodCount> m_Objects{};
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcClient. Calls the functions in "InterfaceT" (an "RpcInterface")
+    // through "TransportT" (see top of this file for the transport
+    // requirements). Each call is synchronous (it returns the function's
+    // result or throws "RpcError"). The request and response buffers are
+    // reused across calls (so no allocation occurs once they've grown large
+    // enough) which means a given "RpcClient" isn't thread safe (use one per
+    // thread).
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename InterfaceT,
+              typename TransportT>
+    class RpcClient
+    {
+    public:
+        explicit RpcClient(TransportT& transport) noexcept
+            : m_Transport(transport)
+        {
+        }
+
+        ////////////////////////////////////////////////////////
+        // Calls "FunctionT" (which must be in "InterfaceT")
+        // with "args" (each converted to its corresponding
+        // parameter type of "FunctionT"), returning its result
+        ////////////////////////////////////////////////////////
+        template <auto FunctionT,
+                  typename... ArgsT>
+        ReturnType_t<decltype(FunctionT)> Call(ArgsT&&... args)
+        {
+            static_assert(InterfaceT::template Contains_v<FunctionT>,
+                          "Function passed to \"RpcClient::Call()\" isn't in the client's \"RpcInterface\"");
+
+            using F = decltype(FunctionT);
+            using ArgsMarshal = Marshal<F>;
+            using R = ReturnType_t<F>;
+
+            const std::size_t argsSize = ArgsMarshal::EncodedSize(args...);
+            m_Request.resize(sizeof(Private::RpcRequestHeader) + argsSize);
+
+            const std::uint64_t callId = ++m_CallId;
+            const Private::RpcRequestHeader header = {InterfaceT::template MethodId_v<FunctionT>, callId};
+            std::memcpy(m_Request.data(), &header, sizeof(header));
+            if (argsSize != 0 && ArgsMarshal::Encode(m_Request.data() + sizeof(header), argsSize, args...) == 0)
+            {
+                throw RpcError(RpcStatus::BadRequest, "Args too large to encode");
+            }
+
+            m_Transport.Transact(m_Request, m_Response);
+
+            const std::byte *const payload = CheckResponse(callId);
+            const std::size_t payloadSize = m_Response.size() - sizeof(Private::RpcResponseHeader);
+
+            if constexpr (!std::is_void_v<R>)
+            {
+                using ReturnMarshal = Private::RpcReturnMarshal<R>;
+                if (!ReturnMarshal::Validate(payload, payloadSize))
+                {
+                    throw RpcError(RpcStatus::BadResponse, "Malformed return value");
+                }
+
+                return ReturnMarshal::DecodeAndInvoke(payload,
+                                                      payloadSize,
+                                                      [](const typename Private::RpcReturn<R>::Wire_t& value)
+                                                      {
+                                                          return Private::RpcReturn<R>::FromWire(value);
+                                                      });
+            }
+        }
+
+    private:
+        ////////////////////////////////////////////////////////
+        // Checks the header of the response just received,
+        // throwing "RpcError" if the call failed, otherwise
+        // returns a pointer to the payload (return value)
+        ////////////////////////////////////////////////////////
+        const std::byte *CheckResponse(std::uint64_t callId) const
+        {
+            if (m_Response.size() < sizeof(Private::RpcResponseHeader))
+            {
+                throw RpcError(RpcStatus::BadResponse, "Response too small");
+            }
+
+            Private::RpcResponseHeader header;
+            std::memcpy(&header, m_Response.data(), sizeof(header));
+            const std::byte *const payload = m_Response.data() + sizeof(header);
+
+            if (header.m_Status != RpcStatus::Ok)
+            {
+                ///////////////////////////////////////////////
+                // Error responses carry a message (but don't
+                // trust it blindly)
+                ///////////////////////////////////////////////
+                using MessageMarshal = Marshal<void (std::string_view)>;
+
+                std::string message = "RPC call failed";
+                const std::size_t payloadSize = m_Response.size() - sizeof(header);
+                if (MessageMarshal::Validate(payload, payloadSize))
+                {
+                    MessageMarshal::DecodeAndInvoke(payload,
+                                                    payloadSize,
+                                                    [&message](std::string_view value)
+                                                    {
+                                                        message = value;
+                                                    });
+                }
+
+                throw RpcError(header.m_Status, message);
+            }
+
+            if (header.m_CallId != callId)
+            {
+                throw RpcError(RpcStatus::BadResponse, "Response doesn't match request");
+            }
+
+            return payload;
+        }
+
+        TransportT& m_Transport;
+        std::uint64_t m_CallId = 0;
+        std::vector<std::byte> m_Request;
+        std::vector<std::byte> m_Response;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcQueueTransport. In-process (loopback) transport. Clients on any
+    // number of threads call "Transact()" which queues the request and waits
+    // for its response, while a server thread calls "Serve()" which
+    // dispatches queued requests to an "RpcServer" until "Close()" is called.
+    // Requests and responses aren't copied (the server reads the client's
+    // request buffer and writes directly into its response buffer). Useful
+    // for testing and for communication between threads.
+    /////////////////////////////////////////////////////////////////////////////
+    class RpcQueueTransport
+    {
+    public:
+        RpcQueueTransport() = default;
+        RpcQueueTransport(const RpcQueueTransport&) = delete;
+        RpcQueueTransport& operator=(const RpcQueueTransport&) = delete;
+
+        void Transact(const std::vector<std::byte>& request, std::vector<std::byte>& response)
+        {
+            PendingCall pendingCall = {&request, &response};
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            if (m_Closed)
+            {
+                throw RpcError(RpcStatus::TransportError, "Transport closed");
+            }
+
+            m_Queue.push_back(&pendingCall);
+            m_RequestAvailable.notify_one();
+
+            m_ResponseReady.wait(lock,
+                                 [this, &pendingCall]
+                                 {
+                                     return pendingCall.m_Done || (m_Closed && !pendingCall.m_Taken);
+                                 });
+
+            if (!pendingCall.m_Done)
+            {
+                m_Queue.erase(std::find(m_Queue.begin(), m_Queue.end(), &pendingCall));
+                throw RpcError(RpcStatus::TransportError, "Transport closed");
+            }
+        }
+
+        ////////////////////////////////////////////////////////
+        // Dispatches requests to "server" until "Close()" is
+        // called (normally from another thread)
+        ////////////////////////////////////////////////////////
+        template <typename ServerT>
+        void Serve(const ServerT& server)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            for (;;)
+            {
+                m_RequestAvailable.wait(lock,
+                                        [this]
+                                        {
+                                            return m_Closed || !m_Queue.empty();
+                                        });
+                if (m_Closed)
+                {
+                    return;
+                }
+
+                PendingCall *const pendingCall = m_Queue.front();
+                m_Queue.pop_front();
+                pendingCall->m_Taken = true;
+
+                lock.unlock();
+                server.Dispatch(pendingCall->m_Request->data(), pendingCall->m_Request->size(), *pendingCall->m_Response);
+                lock.lock();
+
+                pendingCall->m_Done = true;
+                m_ResponseReady.notify_all();
+            }
+        }
+
+        void Close()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Closed = true;
+            m_RequestAvailable.notify_all();
+            m_ResponseReady.notify_all();
+        }
+
+    private:
+        struct PendingCall
+        {
+            const std::vector<std::byte> *m_Request;
+            std::vector<std::byte> *m_Response;
+            bool m_Taken = false;
+            bool m_Done = false;
+        };
+
+        std::mutex m_Mutex;
+        std::condition_variable m_RequestAvailable;
+        std::condition_variable m_ResponseReady;
+        std::deque<PendingCall *> m_Queue;
+        bool m_Closed = false;
+    };
+
+#if defined(RPC_UNIX_SOCKETS_SUPPORTED)
+    // Default limit on the size of a message received by the socket transports below
+    inline constexpr std::size_t RpcDefaultMaxFrameSize = std::size_t{64} * 1024 * 1024;
+
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // Reads or writes exactly "size" bytes on socket "fd",
+        // retrying on partial transfers and EINTR. Returns false
+        // on failure or (for reads) if the peer closed the
+        // connection.
+        ////////////////////////////////////////////////////////////
+        inline bool RpcSocketReadAll(int fd, void *buffer, std::size_t size) noexcept
+        {
+            std::byte *bytes = static_cast<std::byte *>(buffer);
+            while (size != 0)
+            {
+                const ssize_t count = ::recv(fd, bytes, size, 0);
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (count <= 0)
+                {
+                    return false;
+                }
+
+                bytes += count;
+                size -= static_cast<std::size_t>(count);
+            }
+
+            return true;
+        }
+
+        inline bool RpcSocketWriteAll(int fd, const void *buffer, std::size_t size) noexcept
+        {
+            #if defined(MSG_NOSIGNAL)
+                constexpr int flags = MSG_NOSIGNAL; // Don't raise SIGPIPE if the peer disconnected
+            #else
+                constexpr int flags = 0;
+            #endif
+
+            const std::byte *bytes = static_cast<const std::byte *>(buffer);
+            while (size != 0)
+            {
+                const ssize_t count = ::send(fd, bytes, size, flags);
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (count <= 0)
+                {
+                    return false;
+                }
+
+                bytes += count;
+                size -= static_cast<std::size_t>(count);
+            }
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Messages are framed by a 32 bit (native) length prefix.
+        // Reading fails for frames larger than "maxSize" (before
+        // allocating), since the length comes from the peer.
+        ////////////////////////////////////////////////////////////
+        inline bool RpcSocketWriteFrame(int fd, const std::vector<std::byte>& message) noexcept
+        {
+            const std::uint32_t size = static_cast<std::uint32_t>(message.size());
+            return message.size() <= UINT32_MAX &&
+                   RpcSocketWriteAll(fd, &size, sizeof(size)) &&
+                   RpcSocketWriteAll(fd, message.data(), message.size());
+        }
+
+        inline bool RpcSocketReadFrame(int fd, std::vector<std::byte>& message, std::size_t maxSize)
+        {
+            std::uint32_t size;
+            if (!RpcSocketReadAll(fd, &size, sizeof(size)) || size > maxSize)
+            {
+                return false;
+            }
+
+            message.resize(size);
+            return RpcSocketReadAll(fd, message.data(), size);
+        }
+
+        inline sockaddr_un MakeRpcSocketAddress(const std::string& path)
+        {
+            sockaddr_un address{};
+            if (path.size() >= sizeof(address.sun_path))
+            {
+                throw RpcError(RpcStatus::TransportError, "Socket path too long: " + path);
+            }
+
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+            return address;
+        }
+
+        inline std::string GetRpcSocketErrorMessage(const char *operation)
+        {
+            return std::string(operation) + " failed: " + std::strerror(errno);
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcUnixSocketClient. Client transport connecting to an
+    // "RpcUnixSocketListener" over a Unix domain socket (POSIX only). Not
+    // thread safe (use one per thread, or one per "RpcClient"). Responses
+    // larger than "maxFrameSize" bytes are treated as a lost connection.
+    /////////////////////////////////////////////////////////////////////////////
+    class RpcUnixSocketClient
+    {
+    public:
+        explicit RpcUnixSocketClient(const std::string& path, std::size_t maxFrameSize = RpcDefaultMaxFrameSize)
+            : m_Socket(::socket(AF_UNIX, SOCK_STREAM, 0)),
+              m_MaxFrameSize(maxFrameSize)
+        {
+            if (m_Socket < 0)
+            {
+                throw RpcError(RpcStatus::TransportError, Private::GetRpcSocketErrorMessage("socket()"));
+            }
+
+            const sockaddr_un address = Private::MakeRpcSocketAddress(path);
+            if (::connect(m_Socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+            {
+                const std::string message = Private::GetRpcSocketErrorMessage("connect()");
+                ::close(m_Socket);
+                throw RpcError(RpcStatus::TransportError, message);
+            }
+        }
+
+        RpcUnixSocketClient(const RpcUnixSocketClient&) = delete;
+        RpcUnixSocketClient& operator=(const RpcUnixSocketClient&) = delete;
+
+        ~RpcUnixSocketClient()
+        {
+            ::close(m_Socket);
+        }
+
+        void Transact(const std::vector<std::byte>& request, std::vector<std::byte>& response)
+        {
+            if (!Private::RpcSocketWriteFrame(m_Socket, request) ||
+                !Private::RpcSocketReadFrame(m_Socket, response, m_MaxFrameSize))
+            {
+                throw RpcError(RpcStatus::TransportError, "Connection to RPC server lost");
+            }
+        }
+
+    private:
+        int m_Socket;
+        std::size_t m_MaxFrameSize;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // RpcUnixSocketListener. Server transport listening on a Unix domain
+    // socket (POSIX only). "Serve()" accepts connections one at a time
+    // (serving each until the client disconnects) and dispatches their
+    // requests to an "RpcServer" until "Close()" is called (normally from
+    // another thread), which wakes it via a pipe polled along with the
+    // socket (since shutting down a listening socket doesn't unblock
+    // "accept()" on all platforms, e.g., macOS). Any existing file at "path"
+    // is removed first (and on destruction). A client sending a request
+    // larger than "maxFrameSize" bytes is disconnected.
+    /////////////////////////////////////////////////////////////////////////////
+    class RpcUnixSocketListener
+    {
+    public:
+        explicit RpcUnixSocketListener(const std::string& path, std::size_t maxFrameSize = RpcDefaultMaxFrameSize)
+            : m_Path(path),
+              m_Socket(::socket(AF_UNIX, SOCK_STREAM, 0)),
+              m_MaxFrameSize(maxFrameSize)
+        {
+            if (m_Socket < 0)
+            {
+                throw RpcError(RpcStatus::TransportError, Private::GetRpcSocketErrorMessage("socket()"));
+            }
+
+            if (::pipe(m_WakePipe) != 0)
+            {
+                const std::string message = Private::GetRpcSocketErrorMessage("pipe()");
+                ::close(m_Socket);
+                throw RpcError(RpcStatus::TransportError, message);
+            }
+
+            const sockaddr_un address = Private::MakeRpcSocketAddress(path);
+            ::unlink(path.c_str());
+
+            ////////////////////////////////////////////////////
+            // Non-blocking so "accept()" can't block if the
+            // connection "poll()" reported is gone by then
+            ////////////////////////////////////////////////////
+            if (::fcntl(m_Socket, F_SETFL, ::fcntl(m_Socket, F_GETFL) | O_NONBLOCK) != 0 ||
+                ::bind(m_Socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+                ::listen(m_Socket, SOMAXCONN) != 0)
+            {
+                const std::string message = Private::GetRpcSocketErrorMessage("bind()/listen()");
+                ::close(m_Socket);
+                ::close(m_WakePipe[0]);
+                ::close(m_WakePipe[1]);
+                throw RpcError(RpcStatus::TransportError, message);
+            }
+        }
+
+        RpcUnixSocketListener(const RpcUnixSocketListener&) = delete;
+        RpcUnixSocketListener& operator=(const RpcUnixSocketListener&) = delete;
+
+        ~RpcUnixSocketListener()
+        {
+            ::close(m_Socket);
+            ::close(m_WakePipe[0]);
+            ::close(m_WakePipe[1]);
+            ::unlink(m_Path.c_str());
+        }
+
+        template <typename ServerT>
+        void Serve(const ServerT& server)
+        {
+            std::vector<std::byte> request;
+            std::vector<std::byte> response;
+
+            for (;;)
+            {
+                pollfd pollFds[2] = {{m_Socket, POLLIN, 0}, {m_WakePipe[0], POLLIN, 0}};
+                if (::poll(pollFds, 2, -1) < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    break;
+                }
+
+                if (pollFds[1].revents != 0)
+                {
+                    break; // "Close()" called
+                }
+
+                const int connection = ::accept(m_Socket, nullptr, nullptr);
+                if (connection < 0)
+                {
+                    if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        continue;
+                    }
+
+                    break;
+                }
+
+                /////////////////////////////////////////////////
+                // Inherited from the listening socket on some
+                // platforms (but the connection is served with
+                // blocking calls)
+                /////////////////////////////////////////////////
+                ::fcntl(connection, F_SETFL, ::fcntl(connection, F_GETFL) & ~O_NONBLOCK);
+
+                {
+                    ////////////////////////////////////////////////
+                    // Publish the connection under the lock so a
+                    // concurrent "Close()" either sees it (and
+                    // shuts it down) or has already closed, in
+                    // which case we drop it here
+                    ////////////////////////////////////////////////
+                    const std::lock_guard<std::mutex> lock(m_Mutex);
+                    if (m_Closed)
+                    {
+                        ::close(connection);
+                        break;
+                    }
+
+                    m_Connection = connection;
+                }
+
+                while (Private::RpcSocketReadFrame(connection, request, m_MaxFrameSize))
+                {
+                    server.Dispatch(request.data(), request.size(), response);
+                    if (!Private::RpcSocketWriteFrame(connection, response))
+                    {
+                        break;
+                    }
+                }
+
+                ////////////////////////////////////////////////////
+                // Closed under the lock so "Close()" never shuts
+                // down the descriptor after it's been closed (and
+                // possibly reused)
+                ////////////////////////////////////////////////////
+                const std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Connection = -1;
+                ::close(connection);
+            }
+        }
+
+        void Close() noexcept
+        {
+            const std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Closed)
+            {
+                return;
+            }
+            m_Closed = true;
+
+            ///////////////////////////////////////////////////
+            // Unblocks "poll()" (the byte is never read so it
+            // stays readable) and "recv()" in "Serve()"
+            ///////////////////////////////////////////////////
+            const char wake = 0;
+            const ssize_t written = ::write(m_WakePipe[1], &wake, 1); // Can't fail (first write to an empty pipe)
+            (void)written;
+            if (m_Connection >= 0)
+            {
+                ::shutdown(m_Connection, SHUT_RDWR);
+            }
+        }
+
+    private:
+        std::string m_Path;
+        int m_Socket;
+        int m_WakePipe[2]; // Written to by "Close()" to wake "Serve()"
+        std::size_t m_MaxFrameSize;
+        std::mutex m_Mutex; // Guards "m_Connection" (and closing it) and "m_Closed"
+        int m_Connection = -1;
+        bool m_Closed = false;
+    };
+#endif // #if defined(RPC_UNIX_SOCKETS_SUPPORTED)
+} // namespace StdExt
+
+#undef RPC_UNIX_SOCKETS_SUPPORTED
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef RPC (#include guard)
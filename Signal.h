@@ -0,0 +1,428 @@
+#ifndef STDEXT_SIGNAL
+#define STDEXT_SIGNAL
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "Signal", a thread-safe signal
+// (event) whose emission is lock-free and never allocates, e.g.:
+//
+//     Signal<void (int x, int y)> clicked;
+//
+//     clicked.Connect<&OnClick>(); // Free function
+//     clicked.Connect<&Widget::OnClick>(&widget); // Member function
+//     clicked.Connect(&someLambda); // Functor (by pointer, not copied)
+//
+//     clicked.Emit(10, 20); // Or just "clicked(10, 20)"
+//
+// "F" is the signature of the signal (any function type supported by
+// "FunctionTraits", see "FunctionTraits.h", though normally just a plain
+// function type as above), and each slot connected to it must match it
+// exactly, checked at compile time via "IsArgTypesMatch_v" and
+// "IsReturnTypeMatch_v" (i.e., the slot's arg types and return type must
+// be identical to those of "F", so a slot can't silently bind through
+// conversions). Slot return values are ignored. If "F" is "noexcept" then
+// slots must be as well (and "Emit()" is "noexcept").
+//
+// Slots are stored as "Delegate" objects (see "Delegate.h"), so each is
+// two pointers and calling one is a single indirect call. The connected
+// slots are held in an immutable array published through an atomic
+// pointer (read-copy-update): "Connect()" and "Disconnect()" copy the
+// array, modify the copy and publish it (serialized by a mutex, so they
+// may allocate), while "Emit()" only loads the current array and calls
+// each slot in order, so emission never takes a lock and never allocates.
+//
+// A replaced array is reclaimed via epochs: each emission registers
+// itself under the current epoch in one of 8 reader slots (each on its
+// own cache line, chosen per thread), so concurrent emissions from
+// different threads normally don't write to a shared cache line. Each
+// "Connect()" or "Disconnect()" advances the epoch whenever all emissions
+// registered under the previous one have finished, and frees each
+// replaced array once the epoch has advanced twice since it was replaced
+// (at which point no emission can still be using it). Since emissions
+// starting after an advance register under the new epoch, old epochs
+// drain even under sustained emission, so replaced arrays are only kept
+// for as long as the emissions in progress when they were replaced (any
+// left are freed by the destructor).
+//
+// Note that an emission in progress calls the slots connected when it
+// started, so a slot may still be called (once) by another thread just
+// after "Disconnect()" returns. Also note that connecting or
+// disconnecting from within a slot is allowed (it affects later
+// emissions only).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "Delegate.h" #includes "FunctionTraits.h", which #includes
+// "CompilerVersions.h" so all C++ version constants such as
+// CPP17_OR_LATER (tested just below) are available after the
+// following
+////////////////////////////////////////////////////////////////
+#include "Delegate.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+    #include <mutex>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        // Reader slots each "Signal" spreads its emissions over (by thread)
+        inline constexpr std::size_t SignalReaderSlotCount = 8;
+
+        ////////////////////////////////////////////////////////////
+        // Number of emissions in progress registered under an
+        // even and odd epoch respectively (one cache line each)
+        ////////////////////////////////////////////////////////////
+        struct alignas(64) SignalReaderSlot
+        {
+            std::array<std::atomic<std::uint32_t>, 2> m_Counts{};
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Reader slot index of the calling thread (assigned round
+        // robin to threads on first use)
+        ////////////////////////////////////////////////////////////
+        inline std::size_t GetSignalReaderSlotIndex() noexcept
+        {
+            static std::atomic<std::size_t> nextIndex{0};
+            thread_local const std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SignalReaderSlotCount;
+
+            return index;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // "Signal" (declared after this namespace) minus its
+        // "Connect()" members, specialized on the arg types of its
+        // signature so "Emit()" takes them by their exact
+        // (declared) types
+        ////////////////////////////////////////////////////////////
+        template <typename F, typename ArgTypesTupleT>
+        class SignalBase;
+
+        template <typename F, typename... ArgsT>
+        class SignalBase<F, std::tuple<ArgsT...>>
+        {
+        public:
+            using Slot_t = Delegate<F>;
+
+            SignalBase() = default;
+            SignalBase(const SignalBase&) = delete;
+            SignalBase& operator=(const SignalBase&) = delete;
+
+            ~SignalBase()
+            {
+                delete m_Slots.load();
+            }
+
+            ///////////////////////////////////////////////////
+            // Calls each connected slot (in the order
+            // connected) with "args". Lock-free. Note that
+            // "args" are forwarded to each slot so rvalue
+            // reference args may be moved from by an earlier
+            // slot.
+            ///////////////////////////////////////////////////
+            void Emit(ArgsT... args) const noexcept(IsNoexcept_v<F>)
+            {
+                /////////////////////////////////////////////////
+                // Registered under the current epoch before
+                // loading the array (all sequentially
+                // consistent), retrying if the epoch advanced
+                // meanwhile, so a writer that then sees no
+                // emission registered under an epoch knows none
+                // of them can be using an array it retired
+                // during that epoch. Unregistered on exit even
+                // if a slot throws.
+                /////////////////////////////////////////////////
+                SignalReaderSlot& readerSlot = m_ReaderSlots[GetSignalReaderSlotIndex()];
+                std::atomic<std::uint32_t>* count;
+                for (;;)
+                {
+                    const std::uint64_t epoch = m_Epoch.load();
+                    count = &readerSlot.m_Counts[epoch & 1];
+                    count->fetch_add(1);
+                    if (m_Epoch.load() == epoch)
+                    {
+                        break;
+                    }
+
+                    count->fetch_sub(1, std::memory_order_release);
+                }
+                const EmitGuard guard{*count};
+
+                if (const std::vector<Slot_t>* const slots = m_Slots.load())
+                {
+                    for (const Slot_t& slot : *slots)
+                    {
+                        slot(std::forward<ArgsT>(args)...);
+                    }
+                }
+            }
+
+            void operator()(ArgsT... args) const noexcept(IsNoexcept_v<F>)
+            {
+                Emit(std::forward<ArgsT>(args)...);
+            }
+
+            ///////////////////////////////////////////////////
+            // Disconnects the first slot equal to "slot" (as
+            // returned by "Connect()"). Returns false if not
+            // connected.
+            ///////////////////////////////////////////////////
+            bool Disconnect(const Slot_t& slot)
+            {
+                return Update([&slot](std::vector<Slot_t>& slots)
+                              {
+                                  const auto it = std::find(slots.begin(), slots.end(), slot);
+                                  if (it == slots.end())
+                                  {
+                                      return false;
+                                  }
+
+                                  slots.erase(it);
+                                  return true;
+                              });
+            }
+
+            void DisconnectAll()
+            {
+                Update([](std::vector<Slot_t>& slots)
+                       {
+                           slots.clear();
+                           return true;
+                       });
+            }
+
+            std::size_t GetSlotCount() const noexcept
+            {
+                const std::vector<Slot_t>* const slots = m_Slots.load();
+                return slots ? slots->size() : 0;
+            }
+
+        protected:
+            Slot_t Connect(const Slot_t& slot)
+            {
+                Update([&slot](std::vector<Slot_t>& slots)
+                       {
+                           slots.push_back(slot);
+                           return true;
+                       });
+
+                return slot;
+            }
+
+        private:
+            struct EmitGuard
+            {
+                ~EmitGuard()
+                {
+                    m_Count.fetch_sub(1, std::memory_order_release);
+                }
+
+                std::atomic<std::uint32_t>& m_Count;
+            };
+
+            // Replaced array and the epoch it was replaced in
+            struct RetiredSlots
+            {
+                std::unique_ptr<const std::vector<Slot_t>> m_Slots;
+                std::uint64_t m_Epoch;
+            };
+
+            ///////////////////////////////////////////////////
+            // Copies the current slots, applies "modify" to
+            // the copy and (if it returns true) publishes it,
+            // retiring the previous array. Returns the result
+            // of "modify".
+            ///////////////////////////////////////////////////
+            template <typename ModifyT>
+            bool Update(ModifyT modify)
+            {
+                std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+                const std::vector<Slot_t>* const current = m_Slots.load();
+                auto slots = current ? std::make_unique<std::vector<Slot_t>>(*current)
+                                     : std::make_unique<std::vector<Slot_t>>();
+                const bool isModified = modify(*slots);
+                if (isModified)
+                {
+                    if (current)
+                    {
+                        m_Retired.reserve(m_Retired.size() + 1); // Ensures "push_back()" below can't throw
+                    }
+                    m_Slots.store(slots.release());
+
+                    if (current)
+                    {
+                        m_Retired.push_back(RetiredSlots{std::unique_ptr<const std::vector<Slot_t>>(current), m_Epoch.load()});
+                    }
+                }
+
+                Reclaim();
+
+                return isModified;
+            }
+
+            ///////////////////////////////////////////////////
+            // Advances the epoch (up to twice) while all
+            // emissions registered under the previous epoch
+            // have finished, then frees the retired arrays no
+            // emission can still be using, i.e., those retired
+            // at least two epochs ago (emissions registered
+            // under a later epoch loaded a later array). Called
+            // with "m_WriteMutex" locked.
+            ///////////////////////////////////////////////////
+            void Reclaim() noexcept
+            {
+                std::uint64_t epoch = m_Epoch.load();
+                for (int i = 0; i < 2 && IsDrained((epoch + 1) & 1); ++i)
+                {
+                    m_Epoch.store(++epoch);
+                }
+
+                m_Retired.erase(std::remove_if(m_Retired.begin(),
+                                               m_Retired.end(),
+                                               [epoch](const RetiredSlots& retired)
+                                               {
+                                                   return retired.m_Epoch + 2 <= epoch;
+                                               }),
+                                m_Retired.end());
+            }
+
+            ///////////////////////////////////////////////////
+            // True if no emission is registered under an epoch
+            // with parity "parity" (i.e., the epoch before the
+            // current one, since the one before that was
+            // already drained when the current one began)
+            ///////////////////////////////////////////////////
+            bool IsDrained(std::uint64_t parity) const noexcept
+            {
+                for (const SignalReaderSlot& readerSlot : m_ReaderSlots)
+                {
+                    if (readerSlot.m_Counts[parity].load() != 0)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            std::atomic<const std::vector<Slot_t>*> m_Slots{nullptr};
+            std::atomic<std::uint64_t> m_Epoch{0};
+            mutable std::array<SignalReaderSlot, SignalReaderSlotCount> m_ReaderSlots{};
+            std::mutex m_WriteMutex;
+            std::vector<RetiredSlots> m_Retired; // Replaced arrays possibly still in use by an emission
+        };
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Signal. Thread-safe signal with lock-free, allocation-free emission and
+    // slots checked against signature "F" at compile time. See top of this
+    // file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <TRAITS_FUNCTION_C F>
+    class Signal : public Private::SignalBase<F, ArgTypes_t<F>>
+    {
+        /////////////////////////////////////////////////////////
+        // Kicks in if concepts not supported, otherwise the
+        // following resolves to whitespace and the
+        // corresponding concept kicks in in the template
+        // declaration above instead
+        /////////////////////////////////////////////////////////
+        STATIC_ASSERT_IS_TRAITS_FUNCTION(F)
+
+        using BaseClass = Private::SignalBase<F, ArgTypes_t<F>>;
+
+        /////////////////////////////////////////////////////////
+        // True if "TargetF" (the type of a slot) has exactly
+        // our arg types and return type
+        /////////////////////////////////////////////////////////
+        template <typename TargetF>
+        static constexpr bool IsSlotMatch_v = IsArgTypesMatch_v<F, TargetF> && IsReturnTypeMatch_v<F, TargetF>;
+
+    public:
+        using typename BaseClass::Slot_t;
+
+        ////////////////////////////////////////////////////////////
+        // Connects a free function (including a static member
+        // function). Returns the slot (pass to "Disconnect()").
+        ////////////////////////////////////////////////////////////
+        template <auto FunctionT,
+                  std::enable_if_t<IsTraitsFreeFunction_v<std::remove_pointer_t<decltype(FunctionT)>>, int> = 0>
+        Slot_t Connect()
+        {
+            static_assert(IsSlotMatch_v<std::remove_const_t<decltype(FunctionT)>>,
+                          "Function doesn't match the signal's signature (its arg types and return type "
+                          "must be identical)");
+
+            return BaseClass::Connect(Slot_t::template Bind<FunctionT>());
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Connects a non-static member function invoked on
+        // "object" (which must outlive the connection)
+        ////////////////////////////////////////////////////////////
+        template <auto MemberFunctionT>
+        Slot_t Connect(Private::DelegateObject_t<decltype(MemberFunctionT)>* object)
+        {
+            static_assert(IsSlotMatch_v<std::remove_const_t<decltype(MemberFunctionT)>>,
+                          "Member function doesn't match the signal's signature (its arg types and return "
+                          "type must be identical)");
+
+            return BaseClass::Connect(Slot_t::template Bind<MemberFunctionT>(object));
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Connects a functor (including a lambda) by pointer (it
+        // isn't copied so it must outlive the connection)
+        ////////////////////////////////////////////////////////////
+        template <typename FunctorT,
+                  std::enable_if_t<std::is_class_v<FunctorT>, int> = 0>
+        Slot_t Connect(FunctorT* functor)
+        {
+            static_assert(IsSlotMatch_v<std::remove_const_t<FunctorT>>,
+                          "Functor doesn't match the signal's signature (the arg types and return type of "
+                          "its \"operator()\" must be identical)");
+
+            return BaseClass::Connect(Slot_t::Bind(functor));
+        }
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef STDEXT_SIGNAL (#include guard)
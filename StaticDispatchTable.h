@@ -0,0 +1,378 @@
+#ifndef STATIC_DISPATCH_TABLE
+#define STATIC_DISPATCH_TABLE
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class template "StaticDispatchTable", a constant
+// (compile-time) table of functions keyed by name (or any other string,
+// such as a signature), intended to replace the usual runtime map of
+// "std::string" to "std::function" (populated by static initializers)
+// often used for command handlers and the like, e.g.:
+//
+//     void Open(std::string_view args);
+//     void Close(std::string_view args);
+//     void Quit(std::string_view args) noexcept;
+//
+//     using Handler = void (std::string_view);
+//     constexpr auto handlers = MakeStaticDispatchTable<Handler>(MakeDispatchEntry<Handler>("open", &Open),
+//                                                                MakeDispatchEntry<Handler>("close", &Close),
+//                                                                MakeDispatchEntry<Handler>("quit", &Quit));
+//
+//     if (const auto handler = handlers.Find(command))
+//     {
+//         handler(args);
+//     }
+//
+// The table is built entirely at compile time (so it's constant
+// initialized, with no startup cost and no allocations), each function's
+// signature is checked against the required one ("Handler" above) via
+// "IsArgTypesMatch_v" and "IsReturnTypeMatch_v" (see "FunctionTraits.h"),
+// and lookups are O(1) via a minimal perfect hash (also built at compile
+// time) so each lookup costs a single hash of the key (FNV-1a, see
+// "Fnv1aHash()" in "FunctionTraits.h"), one table probe and one string
+// comparison (to reject keys not in the table).
+//
+// The perfect hash uses the "hash and displace" technique: keys are
+// distributed into N buckets by their hash, and for each bucket (largest
+// first) a displacement is searched for that maps all of its keys to
+// unused slots of the N slot table. A lookup then computes the key's
+// bucket, reads its displacement and mixes it into the key's hash to
+// obtain the key's slot. The generic (key agnostic) implementation in
+// namespace "Private" is also used by other headers in this library.
+//
+// Note that duplicate keys (or distinct keys with identical 64 bit
+// hashes, which is extremely unlikely) are reported at compile time (as a
+// failure to evaluate the table as a constant expression, pointing to the
+// offending "throw" statement in this file).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <stdexcept>
+    #include <string_view>
+    #include <type_traits>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        ////////////////////////////////////////////////////////////
+        // PerfectHash. Displacements of a minimal perfect hash
+        // over "N" (distinct) 64 bit key hashes (see top of file),
+        // and the slot assigned to each key (in the order the keys
+        // were passed to "MakePerfectHash()")
+        ////////////////////////////////////////////////////////////
+        template <std::size_t N>
+        struct PerfectHash
+        {
+            std::array<std::uint32_t, N> m_Displacements{};
+            std::array<std::size_t, N> m_Slots{};
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Mixes "displacement" into "hash" (a 64 bit finalizer
+        // so each displacement yields an unrelated slot)
+        ////////////////////////////////////////////////////////////
+        constexpr std::uint64_t MixPerfectHash(std::uint64_t hash, std::uint32_t displacement) noexcept
+        {
+            hash += (displacement + 1) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Returns the slot for key hash "hash" (which is only
+        // meaningful if "hash" is one of the keys the perfect
+        // hash was built from - callers must verify the key
+        // stored in the slot). "N" must be non-zero.
+        ////////////////////////////////////////////////////////////
+        template <std::size_t N>
+        constexpr std::size_t GetPerfectHashSlot(std::uint64_t hash, const std::array<std::uint32_t, N>& displacements) noexcept
+        {
+            return static_cast<std::size_t>(MixPerfectHash(hash, displacements[hash % N]) % N);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Builds a minimal perfect hash over "keyHashes", normally
+        // at compile time (throwing if two key hashes are equal,
+        // which results in a compiler error in a constant
+        // expression). Compile-time cost is O(N^2) which is fine
+        // for the table sizes this is intended for (up to a few
+        // thousand keys).
+        ////////////////////////////////////////////////////////////
+        template <std::size_t N>
+        constexpr PerfectHash<N> MakePerfectHash(const std::array<std::uint64_t, N>& keyHashes)
+        {
+            PerfectHash<N> perfectHash;
+
+            // Number of keys in each bucket
+            std::array<std::size_t, N> bucketSizes{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                for (std::size_t j = i + 1; j < N; ++j)
+                {
+                    if (keyHashes[i] == keyHashes[j])
+                    {
+                        throw std::logic_error("Duplicate key (or colliding key hash) in perfect hash");
+                    }
+                }
+
+                ++bucketSizes[keyHashes[i] % N];
+            }
+
+            // Buckets sorted by size in descending order (largest are the hardest to place so go first)
+            std::array<std::size_t, N> bucketOrder{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                bucketOrder[i] = i;
+            }
+            for (std::size_t i = 1; i < N; ++i)
+            {
+                const std::size_t bucket = bucketOrder[i];
+
+                std::size_t j = i;
+                for (; j > 0 && bucketSizes[bucketOrder[j - 1]] < bucketSizes[bucket]; --j)
+                {
+                    bucketOrder[j] = bucketOrder[j - 1];
+                }
+                bucketOrder[j] = bucket;
+            }
+
+            std::array<bool, N> slotUsed{};
+            std::array<std::size_t, N> bucketKeys{};
+            std::array<std::size_t, N> bucketSlots{};
+
+            for (std::size_t i = 0; i < N && bucketSizes[bucketOrder[i]] != 0; ++i)
+            {
+                const std::size_t bucket = bucketOrder[i];
+
+                std::size_t keyCount = 0;
+                for (std::size_t key = 0; key < N; ++key)
+                {
+                    if (keyHashes[key] % N == bucket)
+                    {
+                        bucketKeys[keyCount++] = key;
+                    }
+                }
+
+                ///////////////////////////////////////////////////
+                // Search for a displacement mapping all keys in
+                // this bucket to distinct, unused slots
+                ///////////////////////////////////////////////////
+                for (std::uint32_t displacement = 0;; ++displacement)
+                {
+                    if (displacement == UINT32_MAX)
+                    {
+                        throw std::logic_error("Unable to build perfect hash");
+                    }
+
+                    bool placed = true;
+                    for (std::size_t k = 0; k < keyCount && placed; ++k)
+                    {
+                        const std::size_t slot = static_cast<std::size_t>(MixPerfectHash(keyHashes[bucketKeys[k]], displacement) % N);
+                        placed = !slotUsed[slot];
+                        for (std::size_t m = 0; m < k && placed; ++m)
+                        {
+                            placed = bucketSlots[m] != slot;
+                        }
+
+                        bucketSlots[k] = slot;
+                    }
+
+                    if (placed)
+                    {
+                        perfectHash.m_Displacements[bucket] = displacement;
+                        for (std::size_t k = 0; k < keyCount; ++k)
+                        {
+                            slotUsed[bucketSlots[k]] = true;
+                            perfectHash.m_Slots[bucketKeys[k]] = bucketSlots[k];
+                        }
+
+                        break;
+                    }
+                }
+            }
+
+            return perfectHash;
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // StaticDispatchEntry. Key (name) and function pair passed to
+    // "MakeStaticDispatchTable()" (normally created via "MakeDispatchEntry()"
+    // below). "F" is the (plain) function type of the table, e.g.,
+    // "void (int)".
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    struct StaticDispatchEntry
+    {
+        static_assert(std::is_function_v<F>,
+                      "\"F\" must be a plain function type (e.g., \"void (int)\")");
+
+        std::string_view m_Name;
+        F *m_Function = nullptr;
+        std::uint64_t m_Hash = 0; // Fnv1aHash(m_Name)
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeDispatchEntry(). Returns a "StaticDispatchEntry" pairing "name" with
+    // "function", which must be a free function (or static member function)
+    // whose arg types and return type match those of "F" exactly (checked at
+    // compile time via "IsArgTypesMatch_v" and "IsReturnTypeMatch_v"). Note
+    // that a "noexcept" function can be stored in a table whose type "F"
+    // isn't "noexcept" (but not vice versa).
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename FunctionT>
+    constexpr StaticDispatchEntry<F> MakeDispatchEntry(std::string_view name, FunctionT function) noexcept
+    {
+        static_assert(IsTraitsFreeFunction_v<FunctionT>,
+                      "\"function\" must be a (pointer to a) free function or static member function");
+        static_assert(IsArgTypesMatch_v<F, FunctionT>,
+                      "Arg types of \"function\" don't match those of the dispatch table's function type \"F\"");
+        static_assert(IsReturnTypeMatch_v<F, FunctionT>,
+                      "Return type of \"function\" doesn't match that of the dispatch table's function type \"F\"");
+        static_assert(std::is_convertible_v<FunctionT, F *>,
+                      "\"function\" isn't convertible to the dispatch table's function pointer type (calling "
+                      "convention differs, or \"F\" is \"noexcept\" but \"function\" isn't)");
+
+        return StaticDispatchEntry<F>{name, function, Fnv1aHash(name)};
+    }
+
+    /////////////////////////////////////////////////////////////////////////////
+    // StaticDispatchTable. Constant table of "N" functions of type "F" keyed by
+    // name, with O(1) lookup via a minimal perfect hash. Always created via
+    // "MakeStaticDispatchTable()" below (normally in a "constexpr" variable).
+    // See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              std::size_t N>
+    class StaticDispatchTable
+    {
+    public:
+        using Function_t = F *;
+        using Entry_t = StaticDispatchEntry<F>;
+
+        static constexpr std::size_t Size_v = N;
+
+        constexpr StaticDispatchTable(const std::array<Entry_t, N>& entries)
+            : StaticDispatchTable(entries, Private::MakePerfectHash(GetHashes(entries)))
+        {
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns the function whose name is "name", or null
+        // if not found
+        ///////////////////////////////////////////////////////
+        constexpr Function_t Find(std::string_view name) const noexcept
+        {
+            if constexpr (N == 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                const std::uint64_t hash = Fnv1aHash(name);
+                const Entry_t& entry = m_Entries[Private::GetPerfectHashSlot(hash, m_Displacements)];
+
+                return entry.m_Hash == hash && entry.m_Name == name ? entry.m_Function : nullptr;
+            }
+        }
+
+        constexpr bool Contains(std::string_view name) const noexcept
+        {
+            return Find(name) != nullptr;
+        }
+
+        ///////////////////////////////////////////////////////
+        // All entries (in slot order, not the order passed to
+        // "MakeStaticDispatchTable()")
+        ///////////////////////////////////////////////////////
+        constexpr const std::array<Entry_t, N>& GetEntries() const noexcept
+        {
+            return m_Entries;
+        }
+
+    private:
+        static constexpr std::array<std::uint64_t, N> GetHashes(const std::array<Entry_t, N>& entries) noexcept
+        {
+            std::array<std::uint64_t, N> hashes{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                hashes[i] = entries[i].m_Hash;
+            }
+
+            return hashes;
+        }
+
+        constexpr StaticDispatchTable(const std::array<Entry_t, N>& entries, const Private::PerfectHash<N>& perfectHash)
+            : m_Entries(),
+              m_Displacements(perfectHash.m_Displacements)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                m_Entries[perfectHash.m_Slots[i]] = entries[i];
+            }
+        }
+
+        std::array<Entry_t, N> m_Entries;
+        std::array<std::uint32_t, N> m_Displacements;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // MakeStaticDispatchTable(). Returns a "StaticDispatchTable" of functions
+    // of type "F" holding "entries" (each normally created via
+    // "MakeDispatchEntry()" above). Normally assigned to a "constexpr"
+    // variable so the table (including its perfect hash) is built at compile
+    // time, in which case duplicate names cause a compiler error.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F,
+              typename... EntriesT>
+    constexpr StaticDispatchTable<F, sizeof...(EntriesT)> MakeStaticDispatchTable(const EntriesT&... entries)
+    {
+        static_assert((std::is_same_v<EntriesT, StaticDispatchEntry<F>> && ...),
+                      "All entries passed to \"MakeStaticDispatchTable()\" must be a \"StaticDispatchEntry<F>\" "
+                      "(normally created via \"MakeDispatchEntry<F>()\")");
+
+        return StaticDispatchTable<F, sizeof...(EntriesT)>(std::array<StaticDispatchEntry<F>, sizeof...(EntriesT)>{entries...});
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef STATIC_DISPATCH_TABLE (#include guard)
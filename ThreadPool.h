@@ -0,0 +1,354 @@
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class "ThreadPool", a work-stealing thread pool
+// used by "Actor" (see "Actor.h") and other headers in this library to
+// run tasks asynchronously, e.g.:
+//
+//     ThreadPool pool; // One worker thread per hardware thread by default
+//     pool.Submit([&] { Process(data); });
+//     pool.Submit(&Callback, context); // "void Callback(void* context)"
+//
+// Each worker thread has its own task queue. Tasks submitted from a
+// worker thread go to that worker's queue (the worker later takes them
+// in LIFO order, which favors tasks whose data is still in its cache),
+// while those submitted from other threads are distributed round-robin
+// over the workers' queues. A worker whose queue is empty steals the
+// oldest task from another worker's queue (FIFO, so large, older tasks
+// tend to be the ones stolen) and only sleeps when there's no task
+// anywhere. Each queue is guarded by its own mutex, rarely contended
+// since thieves spread their attempts over all queues.
+//
+// A task submitted as a function pointer and context ("Submit(function,
+// context)") never allocates (other than when a queue grows), which is
+// how "Actor" schedules itself. Submitting a functor allocates a copy of
+// it (unless it's empty and stateless, such as a captureless lambda).
+// Tasks must not throw ("std::terminate()" is called if they do).
+//
+// Pending tasks are all run before the destructor returns (after which
+// submitting more is undefined behavior).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace StdExt
+{
+    class ThreadPool;
+
+    namespace Private
+    {
+        /////////////////////////////////////////////////////////
+        // A task. Just a function and its context so queues
+        // store tasks by value, with no allocation per task.
+        /////////////////////////////////////////////////////////
+        struct ThreadPoolTask
+        {
+            void (*m_Function)(void* context);
+            void* m_Context;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Worker thread (and its task queue). Each on its own cache
+        // line(s) so workers don't falsely share.
+        ////////////////////////////////////////////////////////////
+        struct alignas(64) ThreadPoolWorker
+        {
+            std::mutex m_Mutex;
+            std::deque<ThreadPoolTask> m_Tasks;
+            std::thread m_Thread;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Pool and worker index of the calling thread (null if not
+        // a worker thread)
+        ////////////////////////////////////////////////////////////
+        struct ThreadPoolCurrentWorker
+        {
+            const ThreadPool* m_Pool;
+            std::size_t m_Index;
+        };
+
+        inline thread_local ThreadPoolCurrentWorker t_ThreadPoolCurrentWorker = {nullptr, 0};
+
+        template <typename FunctorT>
+        void InvokeAndDeleteFunctor(void* context) noexcept
+        {
+            const std::unique_ptr<FunctorT> functor(static_cast<FunctorT*>(context));
+            (*functor)();
+        }
+
+        template <typename FunctorT>
+        void InvokeStatelessFunctor(void*) noexcept
+        {
+            FunctorT()();
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////////
+    // ThreadPool. Work-stealing thread pool. See top of this file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency())
+            : m_Workers(threadCount == 0 ? 1 : threadCount)
+        {
+            for (std::size_t i = 0; i < m_Workers.size(); ++i)
+            {
+                m_Workers[i].m_Thread = std::thread(&ThreadPool::Run, this, i);
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_SleepMutex);
+                m_Stop.store(true);
+            }
+            m_WakeUp.notify_all();
+
+            for (Private::ThreadPoolWorker& worker : m_Workers)
+            {
+                worker.m_Thread.join();
+            }
+        }
+
+        std::size_t GetThreadCount() const noexcept
+        {
+            return m_Workers.size();
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns true if the calling thread is one of this
+        // pool's worker threads
+        ///////////////////////////////////////////////////////
+        bool IsWorkerThread() const noexcept
+        {
+            return Private::t_ThreadPoolCurrentWorker.m_Pool == this;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Runs "function(context)" on a worker thread (never
+        // allocates other than when a queue grows)
+        ///////////////////////////////////////////////////////
+        void Submit(void (*function)(void* context), void* context)
+        {
+            std::size_t index;
+            if (IsWorkerThread())
+            {
+                index = Private::t_ThreadPoolCurrentWorker.m_Index;
+            }
+            else
+            {
+                index = m_NextWorker.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+            }
+
+            ///////////////////////////////////////////////////
+            // Counted before it's queued so the count never
+            // drops below the number of queued tasks
+            ///////////////////////////////////////////////////
+            m_PendingCount.fetch_add(1);
+
+            {
+                Private::ThreadPoolWorker& worker = m_Workers[index];
+                std::lock_guard<std::mutex> lock(worker.m_Mutex);
+                worker.m_Tasks.push_back({function, context});
+            }
+
+            ///////////////////////////////////////////////////
+            // Only wakes a worker if any are sleeping (both
+            // this and the sleeping worker's check are
+            // sequentially consistent so at least one of them
+            // sees the other's update, hence no lost wake-ups)
+            ///////////////////////////////////////////////////
+            if (m_SleepingCount.load() != 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_SleepMutex);
+                }
+                m_WakeUp.notify_one();
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Runs "functor()" on a worker thread (allocates a
+        // copy of "functor" unless it's stateless)
+        ///////////////////////////////////////////////////////
+        template <typename F,
+                  std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>, int> = 0>
+        void Submit(F&& functor)
+        {
+            using FunctorT = std::decay_t<F>;
+            if constexpr (std::is_empty_v<FunctorT> && std::is_default_constructible_v<FunctorT>)
+            {
+                Submit(&Private::InvokeStatelessFunctor<FunctorT>, nullptr);
+            }
+            else
+            {
+                auto copy = std::make_unique<FunctorT>(std::forward<F>(functor));
+                Submit(&Private::InvokeAndDeleteFunctor<FunctorT>, copy.get());
+                copy.release();
+            }
+        }
+
+    private:
+        ///////////////////////////////////////////////////////
+        // Takes a task from worker "index"'s queue (newest
+        // first) or else steals one from another worker's
+        // queue (oldest first)
+        ///////////////////////////////////////////////////////
+        bool TakeTask(std::size_t index, Private::ThreadPoolTask& task)
+        {
+            {
+                Private::ThreadPoolWorker& worker = m_Workers[index];
+                std::lock_guard<std::mutex> lock(worker.m_Mutex);
+                if (!worker.m_Tasks.empty())
+                {
+                    task = worker.m_Tasks.back();
+                    worker.m_Tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for (std::size_t i = 1; i < m_Workers.size(); ++i)
+            {
+                Private::ThreadPoolWorker& victim = m_Workers[(index + i) % m_Workers.size()];
+                std::unique_lock<std::mutex> lock(victim.m_Mutex, std::try_to_lock);
+                if (lock && !victim.m_Tasks.empty())
+                {
+                    task = victim.m_Tasks.front();
+                    victim.m_Tasks.pop_front();
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void Run(std::size_t index) noexcept
+        {
+            Private::t_ThreadPoolCurrentWorker = {this, index};
+
+            for (;;)
+            {
+                Private::ThreadPoolTask task;
+                if (m_PendingCount.load(std::memory_order_relaxed) != 0 && TakeTask(index, task))
+                {
+                    m_PendingCount.fetch_sub(1, std::memory_order_relaxed);
+                    task.m_Function(task.m_Context);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_SleepMutex);
+                m_SleepingCount.fetch_add(1);
+
+                //////////////////////////////////////////////
+                // Pending tasks not yet taken (possibly in a
+                // queue whose lock a thief failed to acquire)?
+                // Retry. Otherwise sleep unless stopping.
+                //////////////////////////////////////////////
+                m_WakeUp.wait(lock, [this] { return m_PendingCount.load() != 0 || m_Stop.load(); });
+                m_SleepingCount.fetch_sub(1);
+
+                if (m_Stop.load() && m_PendingCount.load() == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Fixed array of workers (not a "std::vector" since
+        // workers are neither copyable nor movable)
+        ///////////////////////////////////////////////////////
+        struct WorkerArray
+        {
+            explicit WorkerArray(std::size_t count)
+                : m_Workers(std::make_unique<Private::ThreadPoolWorker[]>(count)),
+                  m_Count(count)
+            {
+            }
+
+            Private::ThreadPoolWorker& operator[](std::size_t index) noexcept
+            {
+                return m_Workers[index];
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_Count;
+            }
+
+            Private::ThreadPoolWorker* begin() noexcept
+            {
+                return m_Workers.get();
+            }
+
+            Private::ThreadPoolWorker* end() noexcept
+            {
+                return m_Workers.get() + m_Count;
+            }
+
+            std::unique_ptr<Private::ThreadPoolWorker[]> m_Workers;
+            std::size_t m_Count;
+        };
+
+        WorkerArray m_Workers;
+        std::atomic<std::size_t> m_NextWorker{0};
+        std::atomic<std::size_t> m_PendingCount{0}; // Tasks submitted but not yet taken
+        std::atomic<std::size_t> m_SleepingCount{0};
+        std::atomic<bool> m_Stop{false};
+        std::mutex m_SleepMutex;
+        std::condition_variable m_WakeUp;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef THREAD_POOL (#include guard)
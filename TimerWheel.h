@@ -0,0 +1,552 @@
+#ifndef TIMER_WHEEL
+#define TIMER_WHEEL
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring class "TimerWheel", a hierarchical timer wheel
+// that schedules deferred calls (timers) expiring after a given number of
+// ticks, e.g.:
+//
+//     TimerWheel timers; // 1 tick = whatever the caller decides, say 1 ms
+//
+//     const TimerId id = timers.Schedule<&OnTimeout>(500, connectionId); // Free function
+//     timers.Schedule<&Connection::Ping>(1000, &connection); // Member function
+//     timers.Schedule(250, [&] { Retry(); }); // Functor
+//
+//     timers.Cancel(id); // If no longer needed
+//
+//     // Event loop
+//     timers.AdvanceTo(NowInMs()); // Calls all timers expired by then
+//
+// Timers are stored in 4 levels of 64 slots each, level "N" covering
+// expiries up to 64^(N + 1) ticks away (so up to 2^24 ticks overall,
+// later expiries being parked in the last slot of the top level and
+// reinserted when reached). Each slot is an intrusive list of timers, so
+// scheduling and cancelling are O(1), and advancing only visits slots
+// holding timers (found via a 64 bit occupancy mask per level), calling
+// all timers expiring at a given tick in one pass and moving those of a
+// higher level slot down a level once the lower levels wrap around
+// (cascading).
+//
+// Each timer is a single node holding its (decayed) args inline, in the
+// packed layout computed from "ArgTypes_t" by "DeferredCall" (see
+// "DeferredCall.h", as used by "CommandQueue"), i.e., the same payloads as
+// "CommandQueue::Push()". Nodes are allocated from slabs (per size class)
+// owned by the wheel and recycled through free lists, so scheduling
+// doesn't allocate once the wheel has grown to its working set. A payload
+// must fit the largest size class (512 bytes including the node's
+// header), checked at compile time (capture large state by pointer
+// instead).
+//
+// "TimerWheel" isn't thread-safe (it's normally owned by an event loop's
+// thread), though timers may schedule or cancel timers (including
+// themselves, a no-op) when called. Timers must not throw
+// ("std::terminate()" is called if they do). Pending timers are destroyed
+// (not called) by the destructor.
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "CommandQueue.h" #includes "FunctionTraits.h", which
+// #includes "CompilerVersions.h" so all C++ version constants
+// such as CPP17_OR_LATER (tested just below) are available
+// after the following
+////////////////////////////////////////////////////////////////
+#include "CommandQueue.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+    #include <new>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+    #if CPP20_OR_LATER
+        #include <bit>
+    #endif
+#endif
+
+#if !CPP20_OR_LATER && defined(MICROSOFT_COMPILER)
+    #include <intrin.h>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        // Node sizes (header plus payload) of each size class
+        inline constexpr std::array<std::size_t, 4> TimerNodeSizeClasses = {64, 128, 256, 512};
+
+        // Nodes allocated at once (per slab) when a size class has no free node
+        inline constexpr std::size_t TimerNodesPerSlab = 64;
+
+        // Wheel geometry (see top of file)
+        inline constexpr std::size_t TimerWheelLevelCount = 4;
+        inline constexpr std::size_t TimerWheelSlotBits = 6;
+        inline constexpr std::size_t TimerWheelSlotCount = std::size_t{1} << TimerWheelSlotBits;
+
+        // Slot index of nodes being called by "TimerWheel::AdvanceTo()" (not in any wheel slot)
+        inline constexpr std::uint16_t TimerExpiringSlot = TimerWheelLevelCount * TimerWheelSlotCount;
+
+        ////////////////////////////////////////////////////////////
+        // Timer node header, followed by its payload (see top of
+        // file). Nodes in a slot form an intrusive list ("m_PPrev"
+        // points at the pointer pointing to the node, so unlinking
+        // needs no reference to the slot). Free nodes have a null
+        // "m_Thunk" and are linked through "m_Next" instead.
+        ////////////////////////////////////////////////////////////
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) TimerNode
+        {
+            void* GetPayload() noexcept
+            {
+                return reinterpret_cast<std::byte*>(this) + sizeof(TimerNode);
+            }
+
+            TimerNode* m_Next;
+            TimerNode** m_PPrev;
+            std::uint64_t m_Expiry; // In ticks
+            CommandThunk_t m_Thunk;
+            std::uint32_t m_Generation; // Incremented whenever the node is freed (see "TimerId")
+            std::uint16_t m_Slot; // Level * "TimerWheelSlotCount" + slot, or "TimerExpiringSlot"
+            std::uint8_t m_SizeClass;
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Index of the smallest size class a node with payload
+        // "PayloadT" fits in (or the number of size classes if
+        // none, or if it's over-aligned)
+        ////////////////////////////////////////////////////////////
+        template <typename PayloadT>
+        constexpr std::size_t GetTimerNodeSizeClass() noexcept
+        {
+            if (alignof(PayloadT) > alignof(TimerNode))
+            {
+                return TimerNodeSizeClasses.size();
+            }
+
+            std::size_t index = 0;
+            while (index < TimerNodeSizeClasses.size() && TimerNodeSizeClasses[index] < sizeof(TimerNode) + sizeof(PayloadT))
+            {
+                ++index;
+            }
+
+            return index;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Index of the lowest set bit of "mask" (non-zero)
+        ////////////////////////////////////////////////////////////
+        inline std::size_t CountTrailingZeros(std::uint64_t mask) noexcept
+        {
+            #if CPP20_OR_LATER
+                return static_cast<std::size_t>(std::countr_zero(mask));
+            #elif defined(MICROSOFT_COMPILER)
+                unsigned long index;
+                _BitScanForward64(&index, mask);
+                return index;
+            #else
+                return static_cast<std::size_t>(__builtin_ctzll(mask));
+            #endif
+        }
+    } // namespace Private
+
+    /////////////////////////////////////////////////////////////////////////
+    // TimerId. Identifies a timer scheduled by "TimerWheel" (for cancelling
+    // it). Remains safe to use (a no-op) after the timer is called or
+    // cancelled, for as long as the wheel exists.
+    /////////////////////////////////////////////////////////////////////////
+    struct TimerId
+    {
+        Private::TimerNode* m_Node = nullptr;
+        std::uint32_t m_Generation = 0;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////
+    // TimerWheel. Hierarchical timer wheel of deferred calls. See top of this
+    // file for details.
+    /////////////////////////////////////////////////////////////////////////////
+    class TimerWheel
+    {
+    public:
+        explicit TimerWheel(std::uint64_t currentTick = 0) noexcept
+            : m_CurrentTick(currentTick)
+        {
+        }
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        ~TimerWheel()
+        {
+            for (Private::TimerNode*& head : m_Slots)
+            {
+                while (head)
+                {
+                    Private::TimerNode* const node = head;
+                    Unlink(node);
+                    node->m_Thunk(node->GetPayload(), false);
+                }
+            }
+        }
+
+        std::uint64_t GetCurrentTick() const noexcept
+        {
+            return m_CurrentTick;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Number of timers scheduled but not yet called (or
+        // cancelled)
+        ///////////////////////////////////////////////////////
+        std::size_t GetPendingCount() const noexcept
+        {
+            return m_PendingCount;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Schedules a call to free function "FunctionV" with
+        // "args" (converted to its decayed arg types) in
+        // "delay" ticks (at the earliest on the next tick).
+        // For a non-static member function "&C::M" the first
+        // arg is the object pointer.
+        ///////////////////////////////////////////////////////
+        template <auto FunctionV, typename... ArgsT>
+        TimerId Schedule(std::uint64_t delay, ArgsT&&... args)
+        {
+            using F = std::remove_const_t<decltype(FunctionV)>;
+            if constexpr (std::is_member_function_pointer_v<F>)
+            {
+                using PayloadT = Private::MemberFunctionCommand<FunctionV>;
+                return ScheduleImpl<PayloadT>(delay, &Private::MemberFunctionCommandThunk<FunctionV>, std::forward<ArgsT>(args)...);
+            }
+            else
+            {
+                static_assert(IsTraitsFreeFunction_v<F>, "\"FunctionV\" must be a pointer to a free or member function");
+
+                using PayloadT = DeferredCall<F>;
+                return ScheduleImpl<PayloadT>(delay, &Private::FreeFunctionCommandThunk<FunctionV>, std::forward<ArgsT>(args)...);
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Schedules a call to "functor" (invoked with no args)
+        // in "delay" ticks
+        ///////////////////////////////////////////////////////
+        template <typename F,
+                  std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>, int> = 0>
+        TimerId Schedule(std::uint64_t delay, F&& functor)
+        {
+            using PayloadT = std::decay_t<F>;
+            return ScheduleImpl<PayloadT>(delay, &Private::FunctorCommandThunk<PayloadT>, std::forward<F>(functor));
+        }
+
+        ///////////////////////////////////////////////////////
+        // Cancels timer "id" (destroying its args). Returns
+        // false if it was already called (or is being
+        // called) or cancelled.
+        ///////////////////////////////////////////////////////
+        bool Cancel(const TimerId& id) noexcept
+        {
+            Private::TimerNode* const node = id.m_Node;
+            if (!node || node->m_Generation != id.m_Generation || !node->m_Thunk)
+            {
+                return false;
+            }
+
+            Unlink(node);
+            node->m_Thunk(node->GetPayload(), false);
+            FreeNode(node);
+            --m_PendingCount;
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Advances the current tick to "tick", calling all
+        // timers expiring by then (in order of expiry).
+        // Returns the number of timers called.
+        ///////////////////////////////////////////////////////
+        std::size_t AdvanceTo(std::uint64_t tick) noexcept
+        {
+            std::size_t calledCount = 0;
+
+            while (m_CurrentTick < tick)
+            {
+                // No timers? Nothing to call or cascade on the way
+                if (m_PendingCount == 0)
+                {
+                    m_CurrentTick = tick;
+                    break;
+                }
+
+                m_CurrentTick = GetNextTick(tick);
+
+                const std::size_t slot = m_CurrentTick & (Private::TimerWheelSlotCount - 1);
+                if (slot == 0)
+                {
+                    Cascade(1);
+                }
+
+                calledCount += CallExpired(slot);
+            }
+
+            return calledCount;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Same as above but advances by "ticks"
+        ///////////////////////////////////////////////////////
+        std::size_t Advance(std::uint64_t ticks = 1) noexcept
+        {
+            return AdvanceTo(m_CurrentTick + ticks);
+        }
+
+    private:
+        using SlotMask_t = std::uint64_t;
+
+        template <typename PayloadT, typename... ArgsT>
+        TimerId ScheduleImpl(std::uint64_t delay, Private::CommandThunk_t thunk, ArgsT&&... args)
+        {
+            constexpr std::size_t sizeClass = Private::GetTimerNodeSizeClass<PayloadT>();
+            static_assert(sizeClass < Private::TimerNodeSizeClasses.size(),
+                          "Timer payload (its decayed args, or the functor) is too large or over-aligned "
+                          "(capture large state by pointer instead)");
+
+            Private::TimerNode* const node = AllocateNode(sizeClass);
+            try
+            {
+                ::new (node->GetPayload()) PayloadT(std::forward<ArgsT>(args)...);
+            }
+            catch (...)
+            {
+                FreeNode(node);
+                throw;
+            }
+
+            node->m_Expiry = m_CurrentTick + (delay == 0 ? 1 : delay);
+            node->m_Thunk = thunk;
+            Insert(node);
+            ++m_PendingCount;
+
+            return TimerId{node, node->m_Generation};
+        }
+
+        ///////////////////////////////////////////////////////
+        // Links "node" into the slot for its expiry (relative
+        // to the current tick, see top of file)
+        ///////////////////////////////////////////////////////
+        void Insert(Private::TimerNode* node) noexcept
+        {
+            constexpr std::uint64_t maxDelta = (std::uint64_t{1} << (Private::TimerWheelLevelCount * Private::TimerWheelSlotBits)) - 1;
+
+            const std::uint64_t delta = node->m_Expiry - m_CurrentTick;
+            const std::uint64_t expiry = delta <= maxDelta ? node->m_Expiry : m_CurrentTick + maxDelta;
+
+            std::size_t level = 0;
+            while ((expiry - m_CurrentTick) >> ((level + 1) * Private::TimerWheelSlotBits) != 0)
+            {
+                ++level;
+            }
+
+            const std::size_t slot = (expiry >> (level * Private::TimerWheelSlotBits)) & (Private::TimerWheelSlotCount - 1);
+            Link(node, level * Private::TimerWheelSlotCount + slot);
+        }
+
+        void Link(Private::TimerNode* node, std::size_t slotIndex) noexcept
+        {
+            Private::TimerNode*& head = m_Slots[slotIndex];
+
+            node->m_Next = head;
+            if (head)
+            {
+                head->m_PPrev = &node->m_Next;
+            }
+            node->m_PPrev = &head;
+            head = node;
+
+            node->m_Slot = static_cast<std::uint16_t>(slotIndex);
+            if (slotIndex != Private::TimerExpiringSlot)
+            {
+                m_SlotMasks[slotIndex / Private::TimerWheelSlotCount] |= SlotMask_t{1} << (slotIndex % Private::TimerWheelSlotCount);
+            }
+        }
+
+        void Unlink(Private::TimerNode* node) noexcept
+        {
+            *node->m_PPrev = node->m_Next;
+            if (node->m_Next)
+            {
+                node->m_Next->m_PPrev = node->m_PPrev;
+            }
+
+            const std::size_t slotIndex = node->m_Slot;
+            if (slotIndex != Private::TimerExpiringSlot && !m_Slots[slotIndex])
+            {
+                m_SlotMasks[slotIndex / Private::TimerWheelSlotCount] &= ~(SlotMask_t{1} << (slotIndex % Private::TimerWheelSlotCount));
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns the next tick (up to "tick") requiring work,
+        // i.e., the next occupied level 0 slot or the next
+        // level 0 wrap-around (cascade), skipping those in
+        // between
+        ///////////////////////////////////////////////////////
+        std::uint64_t GetNextTick(std::uint64_t tick) const noexcept
+        {
+            const std::size_t slot = m_CurrentTick & (Private::TimerWheelSlotCount - 1);
+            const std::uint64_t wrapTick = m_CurrentTick - slot + Private::TimerWheelSlotCount;
+
+            std::uint64_t nextTick = wrapTick;
+            if (slot + 1 < Private::TimerWheelSlotCount)
+            {
+                const SlotMask_t mask = m_SlotMasks[0] >> (slot + 1);
+                if (mask != 0)
+                {
+                    nextTick = m_CurrentTick + 1 + Private::CountTrailingZeros(mask);
+                }
+            }
+
+            return nextTick < tick ? nextTick : tick;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Moves the timers in the current slot of "level" to
+        // lower levels (first cascading the next level if
+        // "level" itself wrapped around)
+        ///////////////////////////////////////////////////////
+        void Cascade(std::size_t level) noexcept
+        {
+            if (level == Private::TimerWheelLevelCount)
+            {
+                return;
+            }
+
+            const std::size_t slot = (m_CurrentTick >> (level * Private::TimerWheelSlotBits)) & (Private::TimerWheelSlotCount - 1);
+            if (slot == 0)
+            {
+                Cascade(level + 1);
+            }
+
+            Private::TimerNode*& head = m_Slots[level * Private::TimerWheelSlotCount + slot];
+            while (head)
+            {
+                Private::TimerNode* const node = head;
+                Unlink(node);
+                Insert(node);
+            }
+        }
+
+        ///////////////////////////////////////////////////////
+        // Calls the timers in level 0 slot "slot" (all expire
+        // at the current tick). They're first moved to the
+        // expiring list so timers called can safely schedule
+        // or cancel others (including those in that list).
+        ///////////////////////////////////////////////////////
+        std::size_t CallExpired(std::size_t slot) noexcept
+        {
+            Private::TimerNode*& head = m_Slots[slot];
+            while (head)
+            {
+                Private::TimerNode* const node = head;
+                Unlink(node);
+                Link(node, Private::TimerExpiringSlot);
+            }
+
+            std::size_t calledCount = 0;
+            Private::TimerNode*& expiringHead = m_Slots[Private::TimerExpiringSlot];
+            while (expiringHead)
+            {
+                Private::TimerNode* const node = expiringHead;
+                Unlink(node);
+
+                /////////////////////////////////////////////////
+                // Null thunk while being called so cancelling
+                // it (from within the call) is a no-op
+                /////////////////////////////////////////////////
+                const Private::CommandThunk_t thunk = node->m_Thunk;
+                node->m_Thunk = nullptr;
+                --m_PendingCount;
+                thunk(node->GetPayload(), true);
+
+                FreeNode(node);
+                ++calledCount;
+            }
+
+            return calledCount;
+        }
+
+        Private::TimerNode* AllocateNode(std::size_t sizeClass)
+        {
+            Private::TimerNode*& freeHead = m_FreeNodes[sizeClass];
+            if (!freeHead)
+            {
+                const std::size_t nodeSize = Private::TimerNodeSizeClasses[sizeClass];
+                m_Slabs.push_back(std::make_unique<std::byte[]>(nodeSize * Private::TimerNodesPerSlab));
+
+                std::byte* const slab = m_Slabs.back().get();
+                for (std::size_t i = Private::TimerNodesPerSlab; i-- > 0;)
+                {
+                    Private::TimerNode* const node = ::new (static_cast<void*>(slab + i * nodeSize)) Private::TimerNode();
+                    node->m_Next = freeHead;
+                    node->m_SizeClass = static_cast<std::uint8_t>(sizeClass);
+                    freeHead = node;
+                }
+            }
+
+            Private::TimerNode* const node = freeHead;
+            freeHead = node->m_Next;
+
+            return node;
+        }
+
+        ///////////////////////////////////////////////////////
+        // Returns "node" (whose payload was destroyed, or
+        // never constructed) to its free list
+        ///////////////////////////////////////////////////////
+        void FreeNode(Private::TimerNode* node) noexcept
+        {
+            node->m_Thunk = nullptr;
+            ++node->m_Generation;
+
+            Private::TimerNode*& freeHead = m_FreeNodes[node->m_SizeClass];
+            node->m_Next = freeHead;
+            freeHead = node;
+        }
+
+        std::uint64_t m_CurrentTick;
+        std::size_t m_PendingCount = 0;
+        std::array<SlotMask_t, Private::TimerWheelLevelCount> m_SlotMasks{}; // Bit set for each non-empty slot
+        std::array<Private::TimerNode*, Private::TimerWheelLevelCount * Private::TimerWheelSlotCount + 1> m_Slots{}; // Last is the expiring list
+        std::array<Private::TimerNode*, Private::TimerNodeSizeClasses.size()> m_FreeNodes{};
+        std::vector<std::unique_ptr<std::byte[]>> m_Slabs;
+    };
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef TIMER_WHEEL (#include guard)
@@ -0,0 +1,299 @@
+#ifndef VISIT
+#define VISIT
+
+/////////////////////////////////////////////////////////////////////////////
+// LICENSE NOTICE
+// --------------
+// Copyright (c) Hexadigm Systems
+//
+// Permission to use this software is granted under the following license:
+// https://www.hexadigm.com/GenericLib/License.html
+//
+// This copyright notice must be included in this and all copies of the
+// software as described in the above license.
+//
+// DESCRIPTION
+// -----------
+// Header file declaring function template "Visit()", an alternative to
+// "std::visit()" for a single "std::variant" and a set of single-arg
+// handlers (one per alternative), e.g.:
+//
+//     using Shape = std::variant<Circle, Square, Triangle>;
+//
+//     const double area = Visit(shape,
+//                               [](const Circle& circle) { return ...; },
+//                               [](const Square& square) { return ...; },
+//                               [](const Triangle& triangle) { return ...; });
+//
+// Instead of building an overload set (the usual "overloaded{...}" idiom)
+// and relying on overload resolution for each alternative, "Visit()"
+// matches each alternative to its handler by type at compile time, using
+// the type of each handler's only arg ("ArgType_t<F, 0>", see
+// "FunctionTraits.h") with cv-qualifiers and references removed. The
+// handlers are indexed by that type once, in a single class deriving
+// from one (empty) tag per handler, so finding the handler for each
+// alternative is one overload resolution (deducing the tag's handler
+// index) rather than a comparison against every handler. The number of
+// templates instantiated therefore grows with the number of alternatives
+// plus handlers (not their product). The result is a flat table with one
+// (small) function per alternative, indexed by "std::variant::index()",
+// so a visit is one indirect call.
+//
+// Each handler can be a functor (including a non-generic lambda) or a
+// pointer to a free function, and must take exactly one arg. Every
+// alternative must be matched by exactly one handler and every handler
+// must match at least one alternative (all checked at compile time), and
+// all handlers must have the same return type, which "Visit()" returns.
+// The alternative is passed with the value category of the variant (so
+// handlers can take an alternative by rvalue reference when the variant
+// is an rvalue). Like "std::visit()", "std::bad_variant_access" is thrown
+// if the variant is valueless (by exception).
+//
+// All declarations in this file are declared in namespace "StdExt".
+// Everything is available for public use except declarations in (nested)
+// namespace "StdExt::Private", which are reserved for internal use only.
+/////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////
+// "FunctionTraits.h" #includes "CompilerVersions.h" so all
+// C++ version constants such as CPP17_OR_LATER (tested just
+// below) are available after the following
+////////////////////////////////////////////////////////////////
+#include "FunctionTraits.h"
+
+//////////////////////////////////////////////////////////////
+// This header supports C++17 and later only. All code below
+// ignored otherwise (preprocessed out).
+//////////////////////////////////////////////////////////////
+#if CPP17_OR_LATER
+
+// "import std" not currently in effect? (C++23 or later)
+#if !defined(STDEXT_IMPORTED_STD)
+    // Standard C/C++ headers
+    #include <array>
+    #include <cstddef>
+    #include <functional>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #include <variant>
+#endif
+
+namespace StdExt
+{
+    namespace Private
+    {
+        template <typename T>
+        struct IsVariant : std::false_type
+        {
+        };
+
+        template <typename... Ts>
+        struct IsVariant<std::variant<Ts...>> : std::true_type
+        {
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Type of alternative handled by "HandlerT" (its only arg
+        // type with cv-qualifiers and references removed)
+        ////////////////////////////////////////////////////////////
+        template <typename HandlerT>
+        using VisitHandlerArg_t = RemoveCvRef_t<ArgType_t<RemoveCvRef_t<HandlerT>, 0>>;
+
+        template <typename HandlerT>
+        constexpr bool IsValidVisitHandler() noexcept
+        {
+            using F = RemoveCvRef_t<HandlerT>;
+
+            static_assert(IsTraitsFreeFunction_v<std::remove_pointer_t<F>> || IsTraitsFunctor_v<F>,
+                          "Handlers passed to \"Visit()\" must be functors (non-generic lambdas included) or "
+                          "pointers to free functions");
+            static_assert(ArgCount_v<F> == 1 && !IsVariadic_v<F>,
+                          "Handlers passed to \"Visit()\" must take exactly one arg (the alternative)");
+
+            return true;
+        }
+
+        // Empty base of "VisitHandlerMap" below for handler "I" of alternative "T"
+        template <typename T,
+                  std::size_t I>
+        struct VisitHandlerTag
+        {
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Maps each handler's alternative (its arg type) to its
+        // index in "HandlersT", via one "VisitHandlerTag" base per
+        // handler
+        ////////////////////////////////////////////////////////////
+        template <typename IndexSequenceT,
+                  typename... HandlersT>
+        struct VisitHandlerMap;
+
+        template <std::size_t... Is,
+                  typename... HandlersT>
+        struct VisitHandlerMap<std::index_sequence<Is...>, HandlersT...> : VisitHandlerTag<VisitHandlerArg_t<HandlersT>, Is>...
+        {
+        };
+
+        // Returned by "FindVisitHandler()" if no handler (or more than one) handles the alternative
+        inline constexpr std::size_t VisitHandlerNotFound = static_cast<std::size_t>(-1);
+
+        ////////////////////////////////////////////////////////////
+        // Index of the handler for alternative "AltT" in the
+        // "VisitHandlerMap" pointed to (its type only matters),
+        // deduced from its unique "VisitHandlerTag" base for
+        // "AltT". Deduction fails (so the overload just below is
+        // chosen) if there's no such base or more than one.
+        ////////////////////////////////////////////////////////////
+        template <typename AltT,
+                  std::size_t I>
+        constexpr std::size_t FindVisitHandler(const VisitHandlerTag<AltT, I>*) noexcept
+        {
+            return I;
+        }
+
+        template <typename AltT>
+        constexpr std::size_t FindVisitHandler(const void*) noexcept
+        {
+            return VisitHandlerNotFound;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // True if the alternative of each handler is unique (so
+        // each finds itself in "MapT", a "VisitHandlerMap")
+        ////////////////////////////////////////////////////////////
+        template <typename MapT,
+                  typename... HandlersT,
+                  std::size_t... Is>
+        constexpr bool IsUniqueVisitHandlers(std::index_sequence<Is...>) noexcept
+        {
+            return ((FindVisitHandler<VisitHandlerArg_t<HandlersT>>(static_cast<const MapT*>(nullptr)) == Is) && ...);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // True if every handler in a "VisitHandlerMap" of
+        // "HandlerCountV" handlers is among "handlerIndexes" (the
+        // handler found for each alternative)
+        ////////////////////////////////////////////////////////////
+        template <std::size_t HandlerCountV,
+                  std::size_t AltCountV>
+        constexpr bool IsEveryVisitHandlerUsed(const std::array<std::size_t, AltCountV>& handlerIndexes) noexcept
+        {
+            std::array<bool, HandlerCountV> isUsed{};
+            for (const std::size_t handlerIndex : handlerIndexes)
+            {
+                if (handlerIndex < HandlerCountV)
+                {
+                    isUsed[handlerIndex] = true;
+                }
+            }
+
+            for (const bool isHandlerUsed : isUsed)
+            {
+                if (!isHandlerUsed)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // "Visit()" for variant "VariantT" (a possibly cv-qualified
+        // "std::variant" reference type) and "HandlersT". "Table_v"
+        // holds one function per alternative, each of which calls
+        // its handler directly.
+        ////////////////////////////////////////////////////////////
+        template <typename VariantT,
+                  typename IndexSequenceT,
+                  typename... HandlersT>
+        struct VisitImpl;
+
+        template <typename VariantT,
+                  std::size_t... Is,
+                  typename... HandlersT>
+        struct VisitImpl<VariantT, std::index_sequence<Is...>, HandlersT...>
+        {
+            using Variant_t = RemoveCvRef_t<VariantT>;
+            using Handlers_t = std::tuple<HandlersT&&...>;
+            using Return_t = ReturnType_t<RemoveCvRef_t<std::tuple_element_t<0, std::tuple<HandlersT...>>>>;
+
+            template <std::size_t I>
+            using Alternative_t = std::variant_alternative_t<I, Variant_t>;
+
+            using HandlerMapT = VisitHandlerMap<std::index_sequence_for<HandlersT...>, HandlersT...>;
+
+            // Index of the handler for each alternative ("VisitHandlerNotFound" if none)
+            static constexpr std::array<std::size_t, sizeof...(Is)> HandlerIndexes_v = {
+                FindVisitHandler<Alternative_t<Is>>(static_cast<const HandlerMapT*>(nullptr))...};
+
+            static_assert(IsUniqueVisitHandlers<HandlerMapT, HandlersT...>(std::index_sequence_for<HandlersT...>()),
+                          "Handlers passed to \"Visit()\" must each handle a different alternative (by the type "
+                          "of their arg, ignoring cv-qualifiers and references)");
+            static_assert(((HandlerIndexes_v[Is] != VisitHandlerNotFound) && ...),
+                          "An alternative of the variant passed to \"Visit()\" isn't handled by any handler (by "
+                          "the type of its arg, ignoring cv-qualifiers and references)");
+            static_assert(IsEveryVisitHandlerUsed<sizeof...(HandlersT)>(HandlerIndexes_v),
+                          "A handler passed to \"Visit()\" doesn't handle any alternative of the variant");
+            static_assert((std::is_same_v<ReturnType_t<RemoveCvRef_t<HandlersT>>, Return_t> && ...),
+                          "All handlers passed to \"Visit()\" must have the same return type");
+
+            template <std::size_t I>
+            static Return_t Invoke(VariantT variant, Handlers_t& handlers)
+            {
+                ///////////////////////////////////////////////////
+                // The alternative, with the variant's value
+                // category (as "std::get()" would return it but
+                // without checking the index, already known)
+                ///////////////////////////////////////////////////
+                using AlternativeRefT = decltype(std::get<I>(std::declval<VariantT>()));
+
+                constexpr std::size_t handlerIndex = HandlerIndexes_v[I];
+                using HandlerT = std::tuple_element_t<handlerIndex, std::tuple<HandlersT...>>;
+
+                static_assert(std::is_invocable_v<HandlerT, AlternativeRefT>,
+                              "A handler passed to \"Visit()\" can't be called with its alternative (e.g., it "
+                              "takes it by non-const reference but the variant is const, or by rvalue "
+                              "reference but the variant isn't an rvalue)");
+
+                return std::invoke(std::forward<HandlerT>(std::get<handlerIndex>(handlers)),
+                                   static_cast<AlternativeRefT>(*std::get_if<I>(&variant)));
+            }
+
+            static constexpr std::array<Return_t (*)(VariantT, Handlers_t&), sizeof...(Is)> Table_v = {&Invoke<Is>...};
+        };
+    } // namespace Private
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Visit(). Calls the handler in "handlers" for the alternative currently
+    // held by "variant" (a "std::variant") with that alternative, returning
+    // the handler's result. See top of this file for details.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename VariantT,
+              typename... HandlersT>
+    decltype(auto) Visit(VariantT&& variant, HandlersT&&... handlers)
+    {
+        static_assert(Private::IsVariant<RemoveCvRef_t<VariantT>>::value,
+                      "\"variant\" must be a \"std::variant\"");
+        static_assert(sizeof...(HandlersT) != 0, "\"Visit()\" requires at least one handler");
+        static_assert((Private::IsValidVisitHandler<HandlersT>() && ...));
+
+        using VisitImplT = Private::VisitImpl<VariantT&&,
+                                              std::make_index_sequence<std::variant_size_v<RemoveCvRef_t<VariantT>>>,
+                                              HandlersT...>;
+
+        if (variant.valueless_by_exception())
+        {
+            throw std::bad_variant_access();
+        }
+
+        typename VisitImplT::Handlers_t handlersTuple(std::forward<HandlersT>(handlers)...);
+        return VisitImplT::Table_v[variant.index()](std::forward<VariantT>(variant), handlersTuple);
+    }
+} // namespace StdExt
+
+#endif // #if CPP17_OR_LATER
+
+#endif // #ifndef VISIT (#include guard)